@@ -8,7 +8,12 @@ set_fix_multiple_port_nets -all -buffer_constants [get_designs *]
 set_host_options -max_core 16
 source ../script/DC.sdc
 
-compile -exact_map -map_effort high
+# map enable-gated registers (e.g. idle VPU lanes) to integrated clock gates,
+# only inside the VPU so the other blocks keep their enable flops
+set_clock_gating_style -sequential_cell latch -positive_edge_logic integrated -control_point before -minimum_bitwidth 4
+set_clock_gating_objects -exclude [remove_from_collection [all_registers] [get_cells -hier * -filter "full_name =~ u_TOP/CPU_wrapper/i_VPU/*"]]
+
+compile -exact_map -map_effort high -gate_clock
 # optimize_registers
 remove_unconnected_ports -blast_buses [get_cells * -hier]
 
@@ -4,6 +4,9 @@
 #define MIP_MTIP (1 << 7)  // Timer interrupt pending
 #define MIP 0x344
 
+// vstart at the last external interrupt (a vector load / store it stopped resumes here)
+volatile uint32_t vstart_trap;
+
 void timer_interrupt_handler(void) {
     volatile unsigned int *WDT_addr = (int *) 0x10010000;
     asm("csrsi mstatus, 0x0"); // MIE of mstatus
@@ -15,6 +18,7 @@ void external_interrupt_handler(void) {
     volatile unsigned int *dma_addr_boot = (int *) 0x10020000;
     asm("csrsi mstatus, 0x0"); // MIE of mstatus
     dma_addr_boot[0x40] = 0;   // disable DMA
+    asm volatile("csrr %0, vstart" : "=r"(vstart_trap));
 }
 
 void trap_handler(void) {
@@ -163,7 +163,8 @@ module AXI (
         unique case (master_priority_q)
             CPU_FETCH : master_priority_n = CPU_MEM;
             CPU_MEM   : master_priority_n = DMA_M;
-            DMA_M     : master_priority_n = CPU_FETCH;
+            DMA_M     : master_priority_n = VPU_M;
+            VPU_M     : master_priority_n = CPU_FETCH;
             default   : master_priority_n = CPU_FETCH;
         endcase
     end
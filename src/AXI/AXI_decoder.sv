@@ -13,6 +13,7 @@ module AXI_decoder (
         else if(addr_i >= `DMA_start_addr  && addr_i <= `DMA_end_addr ) slave_id_o = DMA_S;
         else if(addr_i >= `WDT_start_addr  && addr_i <= `WDT_end_addr ) slave_id_o = WDT;
         else if(addr_i >= `DRAM_start_addr && addr_i <= `DRAM_end_addr) slave_id_o = DRAM;
+        else if(addr_i >= `VSPM_start_addr && addr_i <= `VSPM_end_addr) slave_id_o = VSPM;
 
         if(~valid_i) slave_id_o = DEAULT_SLAVE;
     end
@@ -30,12 +30,17 @@ module CPU (
     input  logic        icache_core_wait_i,
     input  logic [31:0] icache_core_addr_i,
     input  logic [31:0] icache_core_out_i,
+    output logic        icache_pf_req_o,
+    output logic [31:0] icache_pf_addr_o,
+    output logic        icache_inv_o,
 
     // exe stage request to D$
     output logic        dcache_core_request_o,
     output logic [ 3:0] dcache_core_write_o,
     output logic [31:0] dcache_core_addr_o,
     output logic [31:0] dcache_core_in_o,
+    output logic [31:0] dcache_core_pc_o,
+    output CMO_t        dcache_core_cmo_o,
     input  logic        dcache_core_wait_i,
     input  logic [31:0] dcache_core_out_i,
 
@@ -47,6 +52,7 @@ module CPU (
     input  logic        vector_ack_i,
     input  logic        vector_writeback_i,
     input  logic        vector_pend_lsu_i,
+    output logic        vector_trap_o,
 
     // from VPU (writeback interface)
     input  logic        vector_lsu_valid_i,
@@ -114,6 +120,10 @@ module CPU (
     predict_info  BP_info_ID_to_EX;
     logic         BU_flush;
 
+    // a trap restarts the vector instruction CPU waits for in MEM (mepc),
+    // VPU stops it and keeps the element it resumes at in vstart
+    assign vector_trap_o = trap_valid && (mem_uOP.fu == VPU) && ~mem_uOP.valid;
+
     // --------------------------------------------
     //                  CPU Stages                 
     // --------------------------------------------
@@ -132,6 +142,8 @@ module CPU (
         .icache_core_wait_i,
         .icache_core_addr_i,
         .icache_core_out_i,
+        .icache_pf_req_o,
+        .icache_pf_addr_o,
 
         // control flow signals
         .btkn_i            ( btkn             ),
@@ -226,6 +238,9 @@ module CPU (
         .dcache_core_write_o,
         .dcache_core_addr_o,
         .dcache_core_in_o,
+        .dcache_core_pc_o,
+        .dcache_core_cmo_o,
+        .icache_inv_o,
 
         // WB/MEM data forwarding
         .mem_rs1_forward_i ( mem_rs1_forward  ),
@@ -49,6 +49,9 @@ module alu (
             _SB     : alu_result_o = add_result;
             _SH     : alu_result_o = add_result;
             _SW     : alu_result_o = add_result;
+            _CBO_INVAL : alu_result_o = add_result;
+            _CBO_CLEAN : alu_result_o = add_result;
+            _CBO_FLUSH : alu_result_o = add_result;
             _AND    : alu_result_o = and_result;
             _OR     : alu_result_o = or_result;
             _XOR    : alu_result_o = xor_result;
@@ -31,6 +31,9 @@ module exe_stage (
     output logic [ 3:0] dcache_core_write_o,
     output logic [31:0] dcache_core_addr_o,
     output logic [31:0] dcache_core_in_o,
+    output logic [31:0] dcache_core_pc_o,
+    output CMO_t        dcache_core_cmo_o,
+    output logic        icache_inv_o,     // fence.i, I$ drops every line
 
     // WB/MEM data forwarding
     input  logic        wb_rs1_forward_i,
@@ -201,6 +204,10 @@ module exe_stage (
                         BU_flush_o = 1'd0; // No BU_flush_o
                     end
                 end
+        end else if (exe_uOP_i.op == _FENCEI) begin
+            // fence.i: refetch the next instruction after I$ is invalidated
+            BU_flush_o = 1'd1;
+            bta_o      = BU_pc+32'd4;
         end else BU_flush_o = 1'd0; // Non-branch instructions
     end
 
@@ -267,6 +274,19 @@ module exe_stage (
         dcache_core_write_o   = mask << alu_result[1:0];
         dcache_core_addr_o    = alu_result;
         dcache_core_in_o      = store_data;
+        dcache_core_pc_o      = exe_uOP_i.pc;
+
+        // cache maintenance (fence.i writes every dirty line back for the refetch)
+        unique case (exe_uOP_i.op)
+            _CBO_INVAL : dcache_core_cmo_o = CMO_INVAL;
+            _CBO_CLEAN : dcache_core_cmo_o = CMO_CLEAN;
+            _CBO_FLUSH : dcache_core_cmo_o = CMO_FLUSH;
+            _CACHE_INV : dcache_core_cmo_o = CMO_INVAL_ALL;
+            _FENCEI    : dcache_core_cmo_o = CMO_CLEAN_ALL;
+            default    : dcache_core_cmo_o = CMO_NONE;
+        endcase
+
+        icache_inv_o = (exe_uOP_i.op == _FENCEI) && ~stall_i;
     end
 
     // csr buffer unit
@@ -276,14 +296,15 @@ module exe_stage (
     assign exe_pc_o    = exe_pc_q;
 
     always_ff @(posedge clk_i) begin
-        if      (rst_i)     exe_pc_q <= 32'd0;
-        else if (waiting_i) exe_pc_q <= exe_pc_q;
-        else                exe_pc_q <= exe_uOP_i.pc;
+        if      (rst_i)                       exe_pc_q <= 32'd0;
+        else if (waiting_i)                   exe_pc_q <= exe_pc_q;
+        else if (stall_i && uOP_q.fu == VPU)  exe_pc_q <= exe_pc_q; // mepc : restart the vector instruction in MEM
+        else                                  exe_pc_q <= exe_uOP_i.pc;
     end
 
     // VPU frontend (just send out instruction)
     always_comb begin
-        vector_inst_valid_o = (exe_uOP_i.fu == VPU) && ~(stall_i);
+        vector_inst_valid_o = (exe_uOP_i.fu == VPU) && ~(stall_i) && ~(flush_i);
         vector_inst_o       = exe_uOP_i.result;
         vector_xrs1_val_o   = (exe_uOP_i.rs1 != x0) ? (operand1) : (32'd0);
         vector_xrs2_val_o   = (exe_uOP_i.rs2 != x0) ? (operand2) : (32'd0);
@@ -13,6 +13,8 @@ module if_stage (
     input  logic         icache_core_wait_i,
     input  logic [31:0]  icache_core_addr_i,
     input  logic [31:0]  icache_core_out_i,
+    output logic         icache_pf_req_o,  // fetch goes to a BTB-predicted target
+    output logic [31:0]  icache_pf_addr_o,
 
     // control flow signals
     input  logic         btkn_i,
@@ -79,6 +81,10 @@ module if_stage (
         else                        fetch_pc_n = fetch_pc_q + 32'd4;
     end
 
+    // the BTB target is taken as the next pc (same priority as above), let I$ prefetch after it
+    assign icache_pf_req_o  = predict_ready & ~(booting_i | mret_i | trap_valid_i | BU_flush_i | iq_full | fetch_wait | RET);
+    assign icache_pf_addr_o = btb_target;
+
     // update flying request pc value
     always_ff @(posedge clk_i) begin
         if (rst_i) fetch_pc_q <= 32'd0;
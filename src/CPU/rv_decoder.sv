@@ -329,11 +329,18 @@ module rv_decoder (
             CSRS_OP : begin
                 // vector CSRs instruction
                 if (inst[31:20] inside {CSR_VSTART, CSR_VXSAT, CSR_VXRM,
-                                        CSR_VCSR, CSR_VL, CSR_VTYPE, CSR_VLENB}) begin
+                                        CSR_VCSR, CSR_VL, CSR_VTYPE, CSR_VLENB, CSR_VPUSTAT,
+                                        [CSR_VHPM_BASE : CSR_VHPM_LAST]}) begin
                     decode_instr.fu       = VPU;
                     decode_instr.rs1      = rs1;
                     decode_instr.rd       = rd;
                     decode_instr.use_imme = (f3 inside {CSRRWI_FUNC3, CSRRSI_FUNC3, CSRRCI_FUNC3});
+                // cache invalidate CSR: a write makes D$ drop every line (rd is not written),
+                // csrr / csrrs / csrrc with rs1 = x0 (uimm = 0) do not write, they read 0 in the CSR unit
+                end else if (inst[31:20] == CSR_MCACHEINV && ((f3 inside {CSRRW_FUNC3, CSRRWI_FUNC3}) ||
+                                                              ((f3 inside {CSRRS_FUNC3, CSRRC_FUNC3, CSRRSI_FUNC3, CSRRCI_FUNC3}) && rs1 != x0))) begin
+                    decode_instr.fu       = GLSU;
+                    decode_instr.op       = _CACHE_INV;
                 end else begin
                     decode_instr.fu       = CSR;
                     decode_instr.rs1      = rs1;
@@ -361,6 +368,37 @@ module rv_decoder (
                 end
             end
 
+            // scalar memory is in order, fence only orders vector memory
+            // --> VPU holds it until all older vector instructions retire
+            // fence.i / cbo.* go to the D$ (fence.i also refetches the next instruction)
+            FENCE_OP : begin
+                unique case (f3)
+                    FENCE_FUNC3 : begin
+                        decode_instr.fu = VPU;
+                    end
+
+                    FENCEI_FUNC3 : begin
+                        decode_instr.fu = GLSU;
+                        decode_instr.op = _FENCEI;
+                    end
+
+                    CBO_FUNC3 : begin
+                        decode_instr.fu       = GLSU;
+                        decode_instr.rs1      = rs1;
+                        decode_instr.use_imme = 1'b1;
+
+                        unique case (inst[31:20])
+                            CBO_INVAL_FUNC12 : decode_instr.op = _CBO_INVAL;
+                            CBO_CLEAN_FUNC12 : decode_instr.op = _CBO_CLEAN;
+                            CBO_FLUSH_FUNC12 : decode_instr.op = _CBO_FLUSH;
+                            default          : decode_instr.fu = NONE;
+                        endcase
+                    end
+
+                    default : ; // nothing to do
+                endcase
+            end
+
             VECTOR_OP : begin
                 decode_instr.fu = VPU;
 
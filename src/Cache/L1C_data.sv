@@ -6,9 +6,12 @@ module L1C_data (
     input  logic        core_req_i,
     input  logic [ 3:0] core_write_i,
     input  logic [31:0] core_addr_i,
+    input  logic [31:0] core_pc_i,   // pc of the load / store (trains the stride prefetcher)
     input  logic [31:0] core_in_i,
+    input  CMO_t        core_cmo_i,  // cache maintenance (cbo.* / fence.i / cache invalidate CSR)
     output logic        core_wait_o,
     output logic [31:0] core_out_o,
+    output logic        cmo_busy_o,  // a cache maintenance operation (or its write-back) is not done
 
     input  logic        vpu_request_i,
     input  logic [ 3:0] vpu_write_i,
@@ -16,54 +19,334 @@ module L1C_data (
     input  logic [31:0] vpu_in_i,
     output logic        vpu_wait_o,
     output logic [31:0] vpu_out_o,
+    input  logic        vpu_inv_i,   // invalidate the line (written by the non-temporal path)
+    output logic        sb_empty_o,  // no buffered store, memory is up to date
+
+    // VPU prefetch hint, fill the lines of [pf_addr_i, pf_end_i] when D$ is idle
+    input  logic        pf_req_i,
+    input  logic [31:0] pf_addr_i,
+    input  logic [31:0] pf_end_i,
+
+    // drop lines in L2 (invalidated here, or written behind the caches)
+    output logic        inv_req_o,
+    output logic        inv_all_o,
+    output logic [31:0] inv_addr_o,
+    input  logic        inv_busy_i,
+
+    // DMA snoop, clean (DMA read) / flush / drop (DMA write) the lines of a burst
+    input  logic        snoop_req_i,
+    input  CMO_t        snoop_cmo_i,
+    input  logic [31:0] snoop_addr_i,
+    input  logic [ 3:0] snoop_len_i,  // burst length - 1 (words)
+    output logic        snoop_wait_o,
 
     // D$ <-> master1
     output logic        D_req_o,
     output logic [ 3:0] D_write_o,
-    output logic [31:0] D_addr_o,
+    output logic [ 3:0] D_len_o,     // burst length - 1 (line: LINE_WORDS-1, single word: 0)
+    output logic [31:0] D_addr_o,    // a line fill starts at the missing word (WRAP burst)
     output logic [31:0] D_in_o,
+    input  logic        D_in_ready_i, // master1 takes D_in_o (next write beat)
     input  logic        D_wait_i,
     input  logic        D_out_valid_i,
     input  logic [31:0] D_out_i
 );
 
+    // number of outstanding line fills / write-throughs
+    parameter int MSHR_NUM   = 4;
+
+    // 1: write-back / write-allocate, 0: write-through / no-write-allocate
+    parameter bit WRITE_BACK = DCACHE_WRITE_BACK;
+
+    // number of lines in the store buffer (write-through only)
+    parameter int SB_NUM     = 2;
+
+    // cache geometry (see def.svh)
+    parameter int WAYS       = DCACHE_WAYS;
+    parameter int SETS       = DCACHE_SETS;
+    parameter int LINE_BYTES = DCACHE_LINE_BYTES;
+
+    // stride prefetcher: PC-indexed table entries, how many strides ahead to prefetch
+    parameter int RPT_NUM     = 16;
+    parameter int STRIDE_DIST = 2;
+
+    // 1: a VPU load hit in a data column the lookup FSM does not use is served next to it
+    parameter bit DUAL_PORT   = 1'b1;
+
+    // 1: lines replaced by fills are kept in a small fully associative victim cache
+    parameter bit VICTIM_CACHE = 1'b1;
+    parameter int VC_NUM       = 4;
+
+    localparam int MSHR_BITS   = (MSHR_NUM > 1) ? $clog2(MSHR_NUM) : 1;
+    localparam int SB_BITS     = (SB_NUM   > 1) ? $clog2(SB_NUM)   : 1;
+    localparam int RPT_BITS    = (RPT_NUM  > 1) ? $clog2(RPT_NUM)  : 1;
+    localparam int VC_BITS     = (VC_NUM   > 1) ? $clog2(VC_NUM)   : 1;
+    localparam int WAY_BITS    = $clog2(WAYS);
+    localparam int INDEX_BITS  = $clog2(SETS);
+    localparam int OFFSET_BITS = $clog2(LINE_BYTES);
+    localparam int TAG_BITS    = 32 - INDEX_BITS - OFFSET_BITS;
+    localparam int LINE_BITS   = LINE_BYTES * 8;
+    localparam int LINE_WORDS  = LINE_BYTES / 4;
+    localparam int WORD_BITS   = $clog2(LINE_WORDS);
+    localparam int COLS        = LINE_BYTES / 8; // data array columns (64-bit macros side by side)
+    localparam int COL_BITS    = (COLS > 1) ? $clog2(COLS) : 1;
+
+    localparam logic [WORD_BITS-1:0] LAST_WORD = WORD_BITS'(LINE_WORDS - 1);
+
     // --------------------------------------------
     //              Signal Declaration             
     // --------------------------------------------
+    // lookup FSM, one tag / data array access at a time
     typedef enum logic [2:0] {
-        IDLE,       // accept a read/write request from core
+        IDLE,       // accept a request, or write a filled line into the cache
         READ,       // read the data from cache line
         WRITE,      // write the data from core to cache line
-        WAIT_AXI    // wait for axi transfer
+        INVALIDATE, // drop the line if it is in the cache
+        PREFETCH,   // check the prefetch line, fill it if miss
+        EVICT,      // write the filled line, move a dirty victim to the write-back buffer
+        MAINTAIN,   // cache maintenance of a line, or invalidate the whole cache
+        WALK        // write every dirty line back, one line at a time
     } CACHE_STATE_t;
 
+    // bus FSM, serves the oldest MSHR / store buffer line on master1
+    typedef enum logic [2:0] {
+        BUS_IDLE,   // send out the next request
+        BUS_WAIT,   // wait for axi transfer
+        BUS_FILL,   // line is in the fill buffer, wait for the lookup FSM to write it
+        BUS_EVICT,  // write the dirty victim line back (burst of the whole line)
+        BUS_DRAIN   // write the oldest store buffer line (burst of its written words)
+    } BUS_STATE_t;
+
+    typedef enum logic [1:0] {
+        REQ_CORE,
+        REQ_VPU,
+        REQ_PF,     // line fill for prefetch, nobody waits for it
+        REQ_SNOOP   // line maintenance for a DMA burst
+    } REQ_SRC_t;
+
+    // core / vpu request port, holds the request until it is done
+    typedef enum logic [2:0] {
+        PORT_IDLE,  // no request
+        PORT_PEND,  // wait for the lookup FSM
+        PORT_BUSY,  // in the lookup FSM
+        PORT_MSHR,  // wait for an MSHR to finish, then look up again
+        PORT_BUS,   // wait for its own uncached access to finish
+        PORT_SB     // wait for a free store buffer line, then look up again
+    } PORT_STATE_t;
+
+    typedef struct packed {
+        PORT_STATE_t          state;
+        logic [MSHR_BITS-1:0] mshr;   // the MSHR it waits for
+        logic                 replay; // the lookup is already counted
+        logic                 slow;   // missed on the VPU hit port, take the lookup FSM
+        logic                 inv;
+        CMO_t                 cmo;
+        logic [31:0]          addr;
+        logic [ 3:0]          write;
+        logic [31:0]          data;   // write data, then read data
+    } PORT_t;
+
     typedef struct packed {
         logic        valid;
-        logic        is_vpu;
+        REQ_SRC_t    src;
+        logic        replay;
+        logic        inv;
+        CMO_t        cmo;
         logic [31:0] core_addr;
         logic [ 3:0] core_write;
         logic [31:0] core_in;
     } REQ_BUF_t;
 
-    CACHE_STATE_t                 dcache_state_q, dcache_state_n;
-    REQ_BUF_t                     request_buffer_q, request_buffer_n;
+    typedef struct packed {
+        logic                     valid;
+        logic [31-OFFSET_BITS :0] line;     // next line to prefetch
+        logic [31-OFFSET_BITS :0] end_line; // last line to prefetch
+    } PF_BUF_t;
+
+    // lines of a DMA burst, handled one at a time
+    typedef struct packed {
+        logic                     valid;
+        CMO_t                     cmo;
+        logic [31-OFFSET_BITS :0] line;     // next line to handle
+        logic [31-OFFSET_BITS :0] end_line; // last line of the burst
+    } SNOOP_BUF_t;
+
+    // miss status holding register
+    typedef enum logic [1:0] {
+        MSHR_FILL,  // line fill
+        MSHR_WRITE, // uncached store, single word
+        MSHR_READ   // uncached load, single word
+    } MSHR_OP_t;
+
+    typedef struct packed {
+        logic        valid;
+        MSHR_OP_t    op;
+        logic [31:0] addr;
+        logic [ 3:0] strb;
+        logic [31:0] data;
+    } MSHR_t;
+
+    // write-back buffer (one dirty victim line)
+    typedef struct packed {
+        logic                 valid;
+        logic [31:0]          addr;
+        logic [LINE_BITS-1:0] line;
+    } WB_BUF_t;
+
+    // store buffer line (write-through stores to the same line are merged)
+    typedef struct packed {
+        logic                     valid;
+        logic [31-OFFSET_BITS :0] line;
+        logic [LINE_BITS    -1:0] data;
+        logic [LINE_BYTES   -1:0] strb;
+    } SB_t;
+
+    // victim cache entry (a line replaced by a fill)
+    typedef struct packed {
+        logic                     valid;
+        logic                     dirty;
+        logic [31-OFFSET_BITS :0] line;
+        logic [LINE_BITS    -1:0] data;
+    } VC_t;
+
+    // reference prediction table entry (one load / store pc)
+    typedef struct packed {
+        logic        valid;
+        logic [31:0] pc;
+        logic [31:0] addr;   // last address
+        logic [31:0] stride;
+        logic [ 1:0] conf;   // how many times the stride repeated (saturating)
+    } RPT_t;
+
+    CACHE_STATE_t                    dcache_state_q, dcache_state_n;
+    REQ_BUF_t                        request_buffer_q, request_buffer_n;
+    PF_BUF_t                         prefetch_q, prefetch_n;
+    SNOOP_BUF_t                      snoop_q, snoop_n;
+    PORT_t                           port_q[2], port_n[2];
+
+    // request to the lookup FSM (snoop > core > vpu > prefetch)
+    logic                            snoop_pend, core_pend, vpu_pend, pf_pend;
+    logic                            sel_valid;
+    REQ_BUF_t                        sel_req;
+    logic                            accept;
+    logic [31:0]                     hit_data;
+
+    // cache maintenance, a core CMO starts when everything before it is in memory
+    logic                            cmo_ready;
+    logic                            cmo_wait;      // a core CMO / snoop is pending, hold the others back
+    logic [31:0]                     snoop_end;     // last word of the DMA burst
+    logic                            walk_read_q, walk_read_n; // the arrays output the dirty set
+    logic                            walk_found;    // a set has a dirty line
+    logic [INDEX_BITS  -1:0]         walk_set;
+    logic                            walk_vc_found; // a victim cache entry is dirty
+    logic [VC_BITS     -1:0]         walk_vc_id;
+    logic [WAY_BITS    -1:0]         walk_way;      // the dirty way of the set read out
+
+    // stride prefetcher
+    RPT_t                            rpt_q[RPT_NUM], rpt_n[RPT_NUM];
+    logic [RPT_BITS    -1:0]         rpt_index;
+    logic [31:0]                     rpt_stride;    // stride of this access
+    logic [31:0]                     stride_addr;   // STRIDE_DIST strides ahead
+    logic [31-OFFSET_BITS:0]         stride_line;
+    logic                            stride_valid_q, stride_valid_n;
+    logic [31-OFFSET_BITS:0]         stride_line_q, stride_line_n; // last line sent to the lookup FSM
+    logic                            stride_taken;
+
+    // MSHR FIFO, the bus serves the oldest one first
+    MSHR_t                           mshr_q[MSHR_NUM], mshr_n[MSHR_NUM];
+    logic [MSHR_BITS  :0]            mshr_size_q, mshr_size_n;
+    logic [MSHR_BITS-1:0]            head_ptr_q, head_ptr_n;
+    logic [MSHR_BITS-1:0]            tail_ptr_q, tail_ptr_n;
+    logic                            mshr_full;
+    logic                            mshr_alloc;
+    MSHR_t                           mshr_entry;
+    logic                            mshr_pop;
+    logic                            mshr_match;    // the line is being filled
+    logic [MSHR_BITS-1:0]            mshr_match_id;
+
+    // bus FSM / fill buffer
+    BUS_STATE_t                      bus_state_q, bus_state_n;
+    logic [LINE_BITS   -1:0]         fill_line_q, fill_line_n;
+    logic [WORD_BITS   -1:0]         fill_count_q, fill_count_n;
+    logic [WORD_BITS   -1:0]         fill_first, fill_word; // first word of the burst / word of this beat
+    logic                            fill_beat;     // a beat of the line fill arrives
+    logic [31:0]                     beat_data;     // the beat with the buffered stores on top
+    logic                            restart;       // a waiting load takes its word from the bus
+    logic                            fill_write;
+    logic [INDEX_BITS  -1:0]         fill_index;
+
+    // write-back buffer
+    WB_BUF_t                         evict_q, evict_n;
+    logic                            evict_done;
+    logic [WAY_BITS    -1:0]         victim_way;    // tree-PLRU way of the fill set
+    logic                            uncached;      // MMIO / VSPM, never allocated
+    logic [LINE_BITS   -1:0]         fill_data;     // fill line with the buffered stores on top
+
+    // victim cache, replaced in FIFO order
+    VC_t                             vc_q[VC_NUM], vc_n[VC_NUM];
+    logic [VC_BITS   -1:0]           vc_ptr_q, vc_ptr_n;   // next entry to replace
+    logic                            vc_hit;
+    logic [VC_BITS   -1:0]           vc_hit_id;
+    logic [31:0]                     vc_data;
+    logic [INDEX_BITS  -1:0]         victim_set;           // set of the PLRU victim (fill / swap)
+
+    // store buffer, FIFO of lines to write through
+    SB_t                             sb_q[SB_NUM], sb_n[SB_NUM];
+    logic [SB_BITS  :0]              sb_size_q, sb_size_n;
+    logic [SB_BITS-1:0]              sb_head_q, sb_head_n;
+    logic [SB_BITS-1:0]              sb_tail_q, sb_tail_n;
+    logic                            sb_full, sb_empty;
+    logic                            sb_write, sb_pop;
+    logic                            sb_merge;      // the line is already in a store buffer line
+    logic [SB_BITS-1:0]              sb_merge_id;
+    logic                            sb_lock;       // the oldest line is on the bus, no merge
+    logic                            drain_start;
+    logic [WORD_BITS   -1:0]         sb_first, sb_last; // written words of the oldest line
+    logic [LINE_BYTES  -1:0]         store_strb;    // store byte mask in the line
+    logic [LINE_BITS   -1:0]         store_data;    // store data in the line
+
+    logic [WAYS-1:0][LINE_BYTES-1:0] DA_write;
+    logic [LINE_BITS   -1:0]         DA_in;
+    logic                            DA_read;
+    logic [WAYS-1:0][LINE_BITS -1:0] DA_out;
+
+    logic [WAYS        -1:0]         TA_write;
+    logic [TAG_BITS    -1:0]         TA_in;
+    logic                            TA_read;
+    logic [WAYS-1:0][TAG_BITS  -1:0] TA_out;
 
-    logic [`CACHE_WRITE_BITS-1:0] DA_write1, DA_write2;
-    logic [`CACHE_DATA_BITS -1:0] DA_in;
-    logic                         DA_read;
-    logic [`CACHE_DATA_BITS -1:0] DA_out1, DA_out2;
-    logic [31:0]                  read_data1, read_data2;
+    // data array columns (DUAL_PORT), each column has its own address
+    logic [COLS        -1:0]         DA_col;               // columns read by DA_read
+    logic                            lookup_col_q;         // the last lookup read one column, not the whole line
+    logic                            sel_vc_hit;           // the selected request hits the victim cache (read the whole line)
+    logic [COLS        -1:0]         main_col;             // columns the lookup FSM reads / writes
+    logic [INDEX_BITS  -1:0]         col_index[COLS];
+    logic                            col_read[COLS];
+    logic [WAYS-1:0][   7:0]         col_write[COLS];
+    logic [WAYS-1:0][  63:0]         col_out[COLS];
 
-    logic                         TA_write1, TA_write2;
-    logic [`CACHE_TAG_BITS  -1:0] TA_in;
-    logic                         TA_read;
-    logic [`CACHE_TAG_BITS  -1:0] TA_out1, TA_out2;
+    // VPU hit port, a VPU load in the last line it hit reads one column (no tag read)
+    logic                            vport_valid_q;        // a VPU load is in the hit port
+    logic                            vport_start;
+    logic [INDEX_BITS  -1:0]         vport_index;
+    logic [COL_BITS    -1:0]         vport_col;
+    logic                            vport_hit;
+    logic [31:0]                     vport_data;
+    logic                            vline_valid_q, vline_valid_n;
+    logic [31-OFFSET_BITS:0]         vline_q, vline_n;     // last line a VPU load hit
+    logic [WAY_BITS    -1:0]         vline_way_q, vline_way_n;
 
-    logic [`CACHE_INDEX_BITS-1:0] index, read_index;    // address to tag/data array
-    logic [`CACHE_LINES     -1:0] valid1_q, valid1_n;   // valid bit of each cache line (way1)
-    logic [`CACHE_LINES     -1:0] valid2_q, valid2_n;   // valid bit of each cache line (way2)
-    logic [`CACHE_LINES     -1:0] replace_q, replace_n; // the way to replace
-    logic                         hit1, hit2;
+    logic [INDEX_BITS  -1:0]         index, read_index;    // address to tag/data array
+    logic [WORD_BITS   -1:0]         word;                 // word offset in the line
+    logic [SETS-1:0][WAYS-1:0]       valid_q, valid_n;     // valid bit of each way of each set
+    logic [SETS-1:0][WAYS-1:0]       dirty_q, dirty_n;     // line is newer than memory (write-back only)
+    logic [WAYS        -1:0]         hit;                  // hit way (one-hot)
+    logic [WAY_BITS    -1:0]         hit_way;
+
+    // tree-PLRU update (a hit, or a fill)
+    logic                            plru_touch;
+    logic [INDEX_BITS  -1:0]         plru_set;
+    logic [WAY_BITS    -1:0]         plru_way;
 
     // --------------------------------------------
     //               Dcache Controller             
@@ -72,282 +355,1230 @@ module L1C_data (
         if (rst_i) begin
             dcache_state_q   <= IDLE;
             request_buffer_q <= REQ_BUF_t'(0);
-            valid1_q         <= 32'd0;
-            valid2_q         <= 32'd0;
-            replace_q        <= 32'd0;
+            prefetch_q       <= PF_BUF_t'(0);
+            snoop_q          <= SNOOP_BUF_t'(0);
+            port_q[REQ_CORE] <= PORT_t'(0);
+            port_q[REQ_VPU ] <= PORT_t'(0);
+            valid_q          <= (SETS*WAYS)'(0);
+            dirty_q          <= (SETS*WAYS)'(0);
+            walk_read_q      <= 1'b0;
         end else begin
             dcache_state_q   <= dcache_state_n;
             request_buffer_q <= request_buffer_n;
-            valid1_q         <= valid1_n;
-            valid2_q         <= valid2_n;
-            replace_q        <= replace_n;
+            prefetch_q       <= prefetch_n;
+            snoop_q          <= snoop_n;
+            port_q           <= port_n;
+            valid_q          <= valid_n;
+            dirty_q          <= dirty_n;
+            walk_read_q      <= walk_read_n;
         end
     end
 
     always_comb begin
-        index = request_buffer_q.core_addr[`CACHE_INDEX];
-        hit1  = valid1_q[index] && (TA_out1 == request_buffer_q.core_addr[`CACHE_TAG]);
-        hit2  = valid2_q[index] && (TA_out2 == request_buffer_q.core_addr[`CACHE_TAG]);
-
-        case (request_buffer_q.core_addr[`CACHE_OFFEST])
-            2'b00 : {read_data1, read_data2} = {DA_out1[127:96], DA_out2[127:96]};
-            2'b01 : {read_data1, read_data2} = {DA_out1[95 :64], DA_out2[95 :64]};
-            2'b10 : {read_data1, read_data2} = {DA_out1[63 :32], DA_out2[63 :32]};
-            2'b11 : {read_data1, read_data2} = {DA_out1[31 : 0], DA_out2[31 : 0]};
-        endcase
+        index    = request_buffer_q.core_addr[OFFSET_BITS +: INDEX_BITS];
+        word     = request_buffer_q.core_addr[2 +: WORD_BITS];
+        hit      = WAYS'(0);
+        hit_way  = WAY_BITS'(0);
+        hit_data = 32'd0;
+
+        // word 0 is at the top of the line
+        for (int w = 0; w < WAYS; w++) begin
+            if (valid_q[index][w] && (TA_out[w] == request_buffer_q.core_addr[31 -: TAG_BITS])) begin
+                hit[w]   = 1'b1;
+                hit_way  = WAY_BITS'(w);
+                hit_data = DA_out[w][(LAST_WORD - word)*32 +: 32];
+            end
+        end
+
+        // VPU hit port, the way of the last line the VPU hit (still valid and not refilled)
+        vport_index = port_q[REQ_VPU].addr[OFFSET_BITS +: INDEX_BITS];
+        vport_hit   = vline_valid_q && valid_q[vport_index][vline_way_q] && (vline_q == port_q[REQ_VPU].addr[31:OFFSET_BITS]);
+        vport_data  = DA_out[vline_way_q][(LAST_WORD - port_q[REQ_VPU].addr[2 +: WORD_BITS])*32 +: 32];
+
+        // MMIO has side effects and the VPU reads / writes the VSPM directly,
+        // so both go to memory and are never allocated
+        uncached = (request_buffer_q.core_addr[31:28] == 4'h1) ||
+                   (request_buffer_q.core_addr >= `VSPM_start_addr && request_buffer_q.core_addr <= `VSPM_end_addr);
+
+        // store data / byte mask placed in the line
+        store_strb = {request_buffer_q.core_write, (LINE_BYTES-4)'(0)} >> ({word, 2'd0});
+        store_data = {request_buffer_q.core_in,    (LINE_BITS-32)'(0)} >> ({word, 5'd0});
+
+        // secondary miss: the line already has a fill in flight
+        mshr_match    = 1'b0;
+        mshr_match_id = MSHR_BITS'(0);
+
+        for (int i = 0; i < MSHR_NUM; i++) begin
+            if (mshr_q[i].valid && (mshr_q[i].op == MSHR_FILL) && (mshr_q[i].addr[31:OFFSET_BITS] == request_buffer_q.core_addr[31:OFFSET_BITS])) begin
+                mshr_match    = 1'b1;
+                mshr_match_id = MSHR_BITS'(i);
+            end
+        end
+
+        // the store can merge into a buffered line that is not on the bus
+        sb_merge    = 1'b0;
+        sb_merge_id = SB_BITS'(0);
+
+        for (int i = 0; i < SB_NUM; i++) begin
+            if (sb_q[i].valid && (sb_q[i].line == request_buffer_q.core_addr[31:OFFSET_BITS]) && ~(sb_lock && (SB_BITS'(i) == sb_head_q))) begin
+                sb_merge    = 1'b1;
+                sb_merge_id = SB_BITS'(i);
+            end
+        end
+
+        // load-after-store forwarding: buffered stores (oldest first) go on top of the fill line
+        fill_data = fill_line_q;
+        beat_data = D_out_i;
+
+        for (int i = 0; i < SB_NUM; i++) begin
+            if (sb_q[(int'(sb_head_q) + i) % SB_NUM].valid && (sb_q[(int'(sb_head_q) + i) % SB_NUM].line == mshr_q[head_ptr_q].addr[31:OFFSET_BITS])) begin
+                for (int b = 0; b < LINE_BYTES; b++) begin
+                    if (sb_q[(int'(sb_head_q) + i) % SB_NUM].strb[b]) fill_data[b*8 +: 8] = sb_q[(int'(sb_head_q) + i) % SB_NUM].data[b*8 +: 8];
+                end
+
+                for (int b = 0; b < 4; b++) begin
+                    if (sb_q[(int'(sb_head_q) + i) % SB_NUM].strb[(LAST_WORD - fill_word)*4 + b]) beat_data[b*8 +: 8] = sb_q[(int'(sb_head_q) + i) % SB_NUM].data[(LAST_WORD - fill_word)*32 + b*8 +: 8];
+                end
+            end
+        end
     end
 
     always_comb begin
         dcache_state_n   = dcache_state_q;
         request_buffer_n = request_buffer_q;
-        valid1_n         = valid1_q;
-        valid2_n         = valid2_q;
-        replace_n        = replace_q;
+        prefetch_n       = prefetch_q;
+        snoop_n          = snoop_q;
+        port_n           = port_q;
+        valid_n          = valid_q;
+        dirty_n          = dirty_q;
+        evict_n          = evict_q;
+        vc_n             = vc_q;
+        vc_ptr_n         = vc_ptr_q;
+        walk_read_n      = 1'b0;
+
+        accept           = 1'b0;
+        stride_taken     = 1'b0;
+        restart          = 1'b0;
+        sb_write         = 1'b0;
+        mshr_alloc       = 1'b0;
+        mshr_entry       = MSHR_t'(0);
+        sel_valid        = 1'b0;
+        sel_req          = REQ_BUF_t'(0);
 
         // default TA / DA assignment
         read_index = index;
         TA_read    = 1'b0;
-        TA_write1  = 1'b0;
-        TA_write2  = 1'b0;
-        TA_in      = request_buffer_q.core_addr[`CACHE_TAG];
+        TA_write   = WAYS'(0);
+        TA_in      = request_buffer_q.core_addr[31 -: TAG_BITS];
         DA_read    = 1'b0;
-        DA_write1  = 16'd0;
-        DA_write2  = 16'd0;
-        DA_in      = {D_out_i, 96'd0} >> ({request_buffer_q.core_write, 5'd0});
+        DA_col     = {COLS{1'b1}};
+        sel_vc_hit = 1'b0;
+        DA_write   = (WAYS*LINE_BYTES)'(0);
+        DA_in      = store_data;
 
-        // default dcahce request assignment
-        D_req_o   = 1'b0;
-        D_write_o = request_buffer_q.core_write;
-        D_addr_o  = request_buffer_q.core_addr;
-        D_in_o    = request_buffer_q.core_in;
+        vline_valid_n = vline_valid_q;
+        vline_n       = vline_q;
+        vline_way_n   = vline_way_q;
+
+        // a hit is the most recently used way of the set
+        plru_touch = 1'b0;
+        plru_set   = index;
+        plru_way   = hit_way;
+
+        // default core / vpu request assignment
+        core_wait_o = (port_q[REQ_CORE].state != PORT_IDLE) | core_req_i;
+        core_out_o  = port_q[REQ_CORE].data;
+        vpu_wait_o  = (port_q[REQ_VPU ].state != PORT_IDLE) | vpu_request_i;
+        vpu_out_o   = port_q[REQ_VPU ].data;
+
+        // default L2 invalidate assignment
+        inv_req_o  = 1'b0;
+        inv_all_o  = 1'b0;
+        inv_addr_o = request_buffer_q.core_addr;
+
+        // the oldest MSHR finishes --> its own access is done, the others look up again
+        // a store buffer line is written --> stores waiting for a free line look up again
+        for (int p = 0; p < 2; p++) begin
+            if (sb_pop && (port_q[p].state == PORT_SB)) port_n[p].state = PORT_PEND;
+
+            if (mshr_pop && (port_q[p].mshr == head_ptr_q)) begin
+                if (port_q[p].state == PORT_MSHR) port_n[p].state = PORT_PEND;
+
+                if (port_q[p].state == PORT_BUS) begin
+                    port_n[p].state = PORT_IDLE;
+                    port_n[p].data  = fill_line_q[(LAST_WORD - fill_first)*32 +: 32];
+
+                    if (p == REQ_VPU) begin
+                        vpu_wait_o  = 1'b0;
+                        vpu_out_o   = fill_line_q[(LAST_WORD - fill_first)*32 +: 32];
+                    end else begin
+                        core_wait_o = 1'b0;
+                        core_out_o  = fill_line_q[(LAST_WORD - fill_first)*32 +: 32];
+                    end
+                end
+            end
 
-        // default core request assignmnet
-        core_wait_o = (request_buffer_q.valid && ~request_buffer_q.is_vpu) | core_req_i;
-        core_out_o  = request_buffer_q.core_in;
+            // early restart: a load waiting for the line takes its word from the bus,
+            // it does not wait for the rest of the line and the lookup again
+            if (fill_beat && (port_q[p].state == PORT_MSHR) && (port_q[p].mshr == head_ptr_q) && ~(|port_q[p].write) && ~port_q[p].inv &&
+                (port_q[p].addr[31:2] == {mshr_q[head_ptr_q].addr[31:OFFSET_BITS], fill_word})) begin
+                restart         = 1'b1;
+                port_n[p].state = PORT_IDLE;
+                port_n[p].data  = beat_data;
 
-        // default vpu request assignmnet
-        vpu_wait_o = (request_buffer_q.valid && request_buffer_q.is_vpu) | vpu_request_i;
-        vpu_out_o  = request_buffer_q.core_in;
+                if (p == REQ_VPU) begin
+                    vpu_wait_o  = 1'b0;
+                    vpu_out_o   = beat_data;
+                end else begin
+                    core_wait_o = 1'b0;
+                    core_out_o  = beat_data;
+                end
+            end
+        end
 
         unique case (dcache_state_q)
             IDLE : begin
-                // receive a read/write request
-                if (core_req_i) begin
-                    // if core wirte != 0 -> read request
-                    dcache_state_n = (|core_write_i) ? (WRITE) : (READ);
-
-                    // store request info to buffer
-                    request_buffer_n = {1'b1, 1'b0, core_addr_i, core_write_i, core_in_i};
-
-                    // set up tag/data array read
-                    TA_read    = 1'b1;
-                    DA_read    = 1'b1;
-                    read_index = core_addr_i[`CACHE_INDEX];
-
-                // receive vpu request
-                end else if (vpu_request_i) begin
-                    // if core wirte != 0 -> read request
-                    dcache_state_n = (|vpu_write_i) ? (WRITE) : (READ);
-
-                    // store request info to buffer
-                    request_buffer_n = {1'b1, 1'b1, vpu_addr_i, vpu_write_i, vpu_in_i};
-
-                    // set up tag/data array read
-                    TA_read    = 1'b1;
-                    DA_read    = 1'b1;
-                    read_index = vpu_addr_i[`CACHE_INDEX];
+                accept = 1'b1;
+            end
+
+            PREFETCH : begin
+                // already in cache / in flight --> nothing to do
+                // not hit --> allocate like a read miss
+                dcache_state_n         = IDLE;
+                request_buffer_n.valid = 1'b0;
+
+                if (!(|hit) && !vc_hit && !mshr_match && !mshr_full && !uncached) begin
+                    mshr_alloc = 1'b1;
+                    mshr_entry = {1'b1, MSHR_FILL, request_buffer_q.core_addr, 4'd0, 32'd0};
                 end
             end
 
             READ : begin
+                dcache_state_n         = IDLE;
+                request_buffer_n.valid = 1'b0;
+                accept                 = 1'b1;
+
+                // the line is in flight --> wait for the fill, then look up again
+                if (mshr_match) begin
+                    port_n[request_buffer_q.src[0]].state  = (mshr_pop && (mshr_match_id == head_ptr_q)) ? (PORT_PEND) : (PORT_MSHR);
+                    port_n[request_buffer_q.src[0]].mshr   = mshr_match_id;
+                    port_n[request_buffer_q.src[0]].replay = 1'b1;
+
                 // if hit -> just read out
-                if (hit1 || hit2) begin
-                    dcache_state_n           = IDLE;
-                    request_buffer_n.valid   = 1'b0;
-                    request_buffer_n.core_in = (hit1) ? (read_data1) : (read_data2);
-                    replace_n[index]         = (hit1) ? (1'b1) : (1'b0);
+                end else if (|hit) begin
+                    port_n[request_buffer_q.src[0]].state = PORT_IDLE;
+                    port_n[request_buffer_q.src[0]].data  = hit_data;
+                    plru_touch                            = 1'b1;
 
                     // send data back to core earlier
-                    if (request_buffer_q.is_vpu) begin
-                        vpu_wait_o  = 1'b0;
-                        vpu_out_o   = request_buffer_n.core_in;
+                    // (the next VPU loads in this line take the VPU hit port)
+                    if (request_buffer_q.src == REQ_VPU) begin
+                        vpu_wait_o    = 1'b0;
+                        vpu_out_o     = hit_data;
+                        vline_valid_n = 1'b1;
+                        vline_n       = request_buffer_q.core_addr[31:OFFSET_BITS];
+                        vline_way_n   = hit_way;
                     end else begin
                         core_wait_o = 1'b0;
-                        core_out_o  = request_buffer_n.core_in;
+                        core_out_o  = hit_data;
                     end
 
-                    // may receive next request
-                    if (core_req_i) begin
-                        // if core wirte != 0 -> read request
-                        dcache_state_n = (|core_write_i) ? (WRITE) : (READ);
-
-                        // store request info to buffer
-                        request_buffer_n = {1'b1, 1'b0, core_addr_i, core_write_i, core_in_i};
+                // victim cache hit --> swap the line with the PLRU way of the set
+                // (the arrays are written, no new lookup in this cycle); a victim cache hit
+                // reads the whole line, unless the line entered the victim cache in the lookup
+                // cycle, then there is no whole PLRU line and the line stays in the victim cache
+                end else if (vc_hit) begin
+                    if (~lookup_col_q) begin
+                        accept = 1'b0;
 
-                        // set up tag/data array read
-                        TA_read    = 1'b1;
-                        DA_read    = 1'b1;
-                        read_index = core_addr_i[`CACHE_INDEX];
+                        TA_write[victim_way] = 1'b1;
+                        DA_write[victim_way] = {LINE_BYTES{1'b1}};
+                        DA_in                = vc_q[vc_hit_id].data;
+                        plru_touch           = 1'b1;
+                        plru_way             = victim_way;
 
-                     // receive vpu request
-                    end else if (vpu_request_i) begin
-                        // if core wirte != 0 -> read request
-                        dcache_state_n = (|vpu_write_i) ? (WRITE) : (READ);
+                        valid_n[index][victim_way] = 1'b1;
+                        dirty_n[index][victim_way] = vc_q[vc_hit_id].dirty;
+                        vc_n[vc_hit_id]            = {valid_q[index][victim_way], dirty_q[index][victim_way], TA_out[victim_way], index, DA_out[victim_way]};
+                    end
 
-                        // store request info to buffer
-                        request_buffer_n = {1'b1, 1'b1, vpu_addr_i, vpu_write_i, vpu_in_i};
+                    port_n[request_buffer_q.src[0]].state = PORT_IDLE;
+                    port_n[request_buffer_q.src[0]].data  = vc_data;
 
-                        // set up tag/data array read
-                        TA_read    = 1'b1;
-                        DA_read    = 1'b1;
-                        read_index = vpu_addr_i[`CACHE_INDEX];
+                    if (request_buffer_q.src == REQ_VPU) begin
+                        vpu_wait_o  = 1'b0;
+                        vpu_out_o   = vc_data;
+                    end else begin
+                        core_wait_o = 1'b0;
+                        core_out_o  = vc_data;
                     end
 
-                // not hit --> read allocate
+                // no free MSHR --> wait for the oldest one
+                end else if (mshr_full) begin
+                    port_n[request_buffer_q.src[0]].state  = (mshr_pop) ? (PORT_PEND) : (PORT_MSHR);
+                    port_n[request_buffer_q.src[0]].mshr   = head_ptr_q;
+                    port_n[request_buffer_q.src[0]].replay = 1'b1;
+
+                // uncached --> single word read
+                end else if (uncached) begin
+                    mshr_alloc = 1'b1;
+                    mshr_entry = {1'b1, MSHR_READ, request_buffer_q.core_addr, 4'd0, 32'd0};
+
+                    port_n[request_buffer_q.src[0]].state = PORT_BUS;
+                    port_n[request_buffer_q.src[0]].mshr  = tail_ptr_q;
+
+                // not hit --> read allocate, the lookup goes on with other requests
+                // (the fill starts at the missing word)
                 end else begin
-                    // send out read request to master
-                    dcache_state_n = WAIT_AXI;
-                    D_req_o        = 1'b1;
-                    D_addr_o       = {request_buffer_q.core_addr[31:4], 4'd0};
-
-                    // set up tag array write request
-                    TA_write1        = ~replace_q[index];
-                    TA_write2        =  replace_q[index];
-                    valid1_n[index]  = (TA_write1) ? (1'b1) : valid1_q[index];
-                    valid2_n[index]  = (TA_write2) ? (1'b1) : valid2_q[index];
-                    replace_n[index] = (TA_write1) ? (1'b1) : (1'b0);
+                    mshr_alloc = 1'b1;
+                    mshr_entry = {1'b1, MSHR_FILL, request_buffer_q.core_addr[31:2], 2'd0, 4'd0, 32'd0};
+
+                    port_n[request_buffer_q.src[0]].state  = PORT_MSHR;
+                    port_n[request_buffer_q.src[0]].mshr   = tail_ptr_q;
+                    port_n[request_buffer_q.src[0]].replay = 1'b1;
                 end
             end
 
             WRITE : begin
-                // if hit -> write through
-                if (hit1 || hit2) begin
-                    // set up data array write request
-                    if (hit1) DA_write1 = {request_buffer_q.core_write, 12'd0} >> ({request_buffer_q.core_addr[`CACHE_OFFEST], 2'd0});
-                    else      DA_write2 = {request_buffer_q.core_write, 12'd0} >> ({request_buffer_q.core_addr[`CACHE_OFFEST], 2'd0});
+                dcache_state_n         = IDLE;
+                request_buffer_n.valid = 1'b0;
+
+                // the line is in flight --> write after the fill
+                if (mshr_match) begin
+                    port_n[request_buffer_q.src[0]].state  = (mshr_pop && (mshr_match_id == head_ptr_q)) ? (PORT_PEND) : (PORT_MSHR);
+                    port_n[request_buffer_q.src[0]].mshr   = mshr_match_id;
+                    port_n[request_buffer_q.src[0]].replay = 1'b1;
+
+                // write-back hit --> only write the line and mark it dirty
+                end else if (WRITE_BACK && (|hit)) begin
+                    DA_write[hit_way]       = store_strb;
+                    dirty_n[index][hit_way] = 1'b1;
+                    plru_touch              = 1'b1;
+
+                    port_n[request_buffer_q.src[0]].state = PORT_IDLE;
+
+                    if (request_buffer_q.src == REQ_VPU) vpu_wait_o  = 1'b0;
+                    else                                 core_wait_o = 1'b0;
+
+                // write-back victim cache hit --> write the line in the victim cache and mark it dirty
+                end else if (WRITE_BACK && vc_hit) begin
+                    for (int b = 0; b < LINE_BYTES; b++) begin
+                        if (store_strb[b]) vc_n[vc_hit_id].data[b*8 +: 8] = store_data[b*8 +: 8];
+                    end
+
+                    vc_n[vc_hit_id].dirty = 1'b1;
+
+                    port_n[request_buffer_q.src[0]].state = PORT_IDLE;
+
+                    if (request_buffer_q.src == REQ_VPU) vpu_wait_o  = 1'b0;
+                    else                                 core_wait_o = 1'b0;
+
+                // write-through --> write the line if hit, the store buffer writes memory later
+                end else if (~WRITE_BACK && ~uncached) begin
+                    if (sb_merge || ~sb_full) begin
+                        if (|hit) DA_write[hit_way] = store_strb;
 
-                    DA_in = {request_buffer_q.core_in, 96'd0} >> ({request_buffer_q.core_addr[`CACHE_OFFEST], 5'd0});
+                        // update lru
+                        plru_touch = (|hit);
 
-                    // update lru
-                    replace_n[index] = (hit1) ? (1'b1) : (1'b0);
+                        // the victim cache copy is kept up to date too
+                        if (vc_hit) begin
+                            for (int b = 0; b < LINE_BYTES; b++) begin
+                                if (store_strb[b]) vc_n[vc_hit_id].data[b*8 +: 8] = store_data[b*8 +: 8];
+                            end
+                        end
+
+                        sb_write = 1'b1;
+
+                        port_n[request_buffer_q.src[0]].state = PORT_IDLE;
+
+                        if (request_buffer_q.src == REQ_VPU) vpu_wait_o  = 1'b0;
+                        else                                 core_wait_o = 1'b0;
+
+                    // no free store buffer line --> wait for the oldest one to be written
+                    end else begin
+                        port_n[request_buffer_q.src[0]].state  = (sb_pop) ? (PORT_PEND) : (PORT_SB);
+                        port_n[request_buffer_q.src[0]].replay = 1'b1;
+                    end
+
+                // no free MSHR --> wait for the oldest one
+                end else if (mshr_full) begin
+                    port_n[request_buffer_q.src[0]].state  = (mshr_pop) ? (PORT_PEND) : (PORT_MSHR);
+                    port_n[request_buffer_q.src[0]].mshr   = head_ptr_q;
+                    port_n[request_buffer_q.src[0]].replay = 1'b1;
+
+                // write-back miss --> write allocate, write the line after the fill
+                end else if (WRITE_BACK && ~uncached) begin
+                    mshr_alloc = 1'b1;
+                    mshr_entry = {1'b1, MSHR_FILL, request_buffer_q.core_addr[31:2], 2'd0, 4'd0, 32'd0};
+
+                    port_n[request_buffer_q.src[0]].state  = PORT_MSHR;
+                    port_n[request_buffer_q.src[0]].mshr   = tail_ptr_q;
+                    port_n[request_buffer_q.src[0]].replay = 1'b1;
+
+                // uncached --> single word write, the store waits for it
+                end else begin
+                    mshr_alloc = 1'b1;
+                    mshr_entry = {1'b1, MSHR_WRITE, request_buffer_q.core_addr, request_buffer_q.core_write, request_buffer_q.core_in};
+
+                    port_n[request_buffer_q.src[0]].state = PORT_BUS;
+                    port_n[request_buffer_q.src[0]].mshr  = tail_ptr_q;
                 end
+            end
+
+            INVALIDATE : begin
+                dcache_state_n         = IDLE;
+                request_buffer_n.valid = 1'b0;
+                accept                 = 1'b1;
+
+                // the line is in flight --> drop it after the fill
+                if (mshr_match) begin
+                    port_n[REQ_VPU].state  = (mshr_pop && (mshr_match_id == head_ptr_q)) ? (PORT_PEND) : (PORT_MSHR);
+                    port_n[REQ_VPU].mshr   = mshr_match_id;
+                    port_n[REQ_VPU].replay = 1'b1;
+
+                // the non-temporal path is only used with write-through,
+                // memory is already up to date, just drop the line
+                end else begin
+                    valid_n[index] = valid_q[index] & ~hit;
+                    inv_req_o      = 1'b1;
+
+                    if (vc_hit) vc_n[vc_hit_id].valid = 1'b0;
 
-                // send out write request to memory
-                D_req_o        = 1'b1;
-                dcache_state_n = WAIT_AXI;
+                    port_n[REQ_VPU].state = PORT_IDLE;
+                    vpu_wait_o            = 1'b0;
+                end
             end
 
-            WAIT_AXI : begin
-                // read allocate (whole cache line to wrire)
-                if (D_out_valid_i) begin
-                    // set up data array write request, replace_q is already updated in read state
-                    // --> when replace_q is way 1 (1'b0), we need to write data in way2
-                    // --> when replace_q is way 2 (1'b1), we need to write data in way1
-                    if (replace_q[index] == 1'b0) begin
-                        DA_write2 = 16'hf000 >> ({request_buffer_q.core_write, 2'd0});
-                    end else begin
-                        DA_write1 = 16'hf000 >> ({request_buffer_q.core_write, 2'd0});
+            // all earlier accesses are in memory, no MSHR / store buffer line / write-back is pending
+            // (the write-back sent here goes to memory before any later access)
+            MAINTAIN : begin
+                dcache_state_n         = IDLE;
+                request_buffer_n.valid = 1'b0;
+
+                unique case (request_buffer_q.cmo)
+                    CMO_INVAL_ALL : begin
+                        valid_n   = (SETS*WAYS)'(0);
+                        dirty_n   = (SETS*WAYS)'(0);
+                        inv_all_o = 1'b1;
+
+                        foreach (vc_n[i]) begin
+                            vc_n[i].valid = 1'b0;
+                        end
                     end
 
-                    // use core_wrire to indicate how many words we have read
-                    request_buffer_n.core_write = request_buffer_q.core_write + 4'd1;
+                    default : begin
+                        // clean / flush --> write the dirty line back
+                        if (request_buffer_q.cmo != CMO_INVAL) begin
+                            if ((|hit) && dirty_q[index][hit_way]) begin
+                                evict_n                 = {1'b1, request_buffer_q.core_addr[31:OFFSET_BITS], OFFSET_BITS'(0), DA_out[hit_way]};
+                                dirty_n[index][hit_way] = 1'b0;
+                            end
 
-                    // store the read data for core in request buffer
-                    if (request_buffer_q.core_write[1:0] == request_buffer_q.core_addr[3:2]) begin
-                        request_buffer_n.core_in = D_out_i;
+                            if (vc_hit && vc_q[vc_hit_id].dirty) begin
+                                evict_n               = {1'b1, vc_q[vc_hit_id].line, OFFSET_BITS'(0), vc_q[vc_hit_id].data};
+                                vc_n[vc_hit_id].dirty = 1'b0;
+                            end
+                        end
+
+                        // inval / flush --> drop the line here and in L2 (cbo.inval drops dirty data)
+                        if (request_buffer_q.cmo != CMO_CLEAN) begin
+                            valid_n[index] = valid_q[index] & ~hit;
+                            dirty_n[index] = dirty_q[index] & ~hit;
+                            inv_req_o      = 1'b1;
+
+                            if (vc_hit) vc_n[vc_hit_id].valid = 1'b0;
+                        end
                     end
+                endcase
 
-                // the data is all writen in data array
-                // or write through is finish
-                end else if (!D_wait_i) begin
+                // a snoop line is done, the next one is already in snoop_q
+                if (request_buffer_q.src == REQ_CORE) begin
+                    port_n[REQ_CORE].state = PORT_IDLE;
+                    core_wait_o            = 1'b0;
+                end
+            end
+
+            // write back the dirty lines of the first dirty set, then the dirty victims
+            WALK : begin
+                // the arrays output the dirty set --> one dirty way to the write-back buffer
+                if (walk_read_q) begin
+                    evict_n                  = {1'b1, TA_out[walk_way], index, OFFSET_BITS'(0), DA_out[walk_way]};
+                    dirty_n[index][walk_way] = 1'b0;
+
+                // read out the next dirty set when the write-back buffer is free
+                end else if (walk_found) begin
+                    if (!evict_q.valid) begin
+                        TA_read     = 1'b1;
+                        DA_read     = 1'b1;
+                        read_index  = walk_set;
+                        walk_read_n = 1'b1;
+
+                        request_buffer_n.core_addr[OFFSET_BITS +: INDEX_BITS] = walk_set;
+                    end
+
+                end else if (walk_vc_found) begin
+                    if (!evict_q.valid) begin
+                        evict_n                = {1'b1, vc_q[walk_vc_id].line, OFFSET_BITS'(0), vc_q[walk_vc_id].data};
+                        vc_n[walk_vc_id].dirty = 1'b0;
+                    end
+
+                // nothing is dirty (the last write-back may still be on the bus, cmo_busy_o covers it)
+                end else begin
                     dcache_state_n         = IDLE;
                     request_buffer_n.valid = 1'b0;
-                    
-                    if (request_buffer_q.is_vpu) begin
-                        vpu_wait_o  = 1'b0;
-                    end else begin
-                        core_wait_o = 1'b0;
+                    port_n[REQ_CORE].state = PORT_IDLE;
+                    core_wait_o            = 1'b0;
+                end
+            end
+
+            EVICT : begin
+                // tag / data array output is the victim line (read in IDLE)
+                dcache_state_n = IDLE;
+
+                // the victim goes to the victim cache, the entry it replaces is dropped (written back if dirty)
+                if (VICTIM_CACHE) begin
+                    if (valid_q[fill_index][victim_way]) begin
+                        vc_n[vc_ptr_q] = {1'b1, dirty_q[fill_index][victim_way], TA_out[victim_way], fill_index, DA_out[victim_way]};
+                        vc_ptr_n       = (vc_ptr_q == VC_BITS'(VC_NUM - 1)) ? (VC_BITS'(0)) : (vc_ptr_q + VC_BITS'(1));
+
+                        if (vc_q[vc_ptr_q].valid && vc_q[vc_ptr_q].dirty) begin
+                            evict_n = {1'b1, vc_q[vc_ptr_q].line, OFFSET_BITS'(0), vc_q[vc_ptr_q].data};
+                        end
                     end
 
-                    // receive next read/write request
-                    if (core_req_i) begin
-                        // if core_wirte != 0 -> read request
-                        dcache_state_n = (|core_write_i) ? (WRITE) : (READ);
+                end else if (valid_q[fill_index][victim_way] && dirty_q[fill_index][victim_way]) begin
+                    evict_n = {1'b1, TA_out[victim_way], fill_index, OFFSET_BITS'(0), DA_out[victim_way]};
+                end
+            end
+
+            default : dcache_state_n = IDLE;
+        endcase
+
+        // VPU hit port: a hit is done, anything else goes to the lookup FSM
+        if (vport_valid_q) begin
+            if (vport_hit) begin
+                port_n[REQ_VPU].state = PORT_IDLE;
+                port_n[REQ_VPU].data  = vport_data;
+                vpu_wait_o            = 1'b0;
+                vpu_out_o             = vport_data;
+            end else begin
+                port_n[REQ_VPU].state = PORT_PEND;
+                port_n[REQ_VPU].slow  = 1'b1;
+            end
+        end
+
+        // hold the new request until the lookup FSM takes it
+        // (a port may send the next request in the cycle its last one is done)
+        if (core_req_i)    port_n[REQ_CORE] = {PORT_PEND, MSHR_BITS'(0), 1'b0, 1'b0, 1'b0,      core_cmo_i, core_addr_i, core_write_i, core_in_i};
+        if (vpu_request_i) port_n[REQ_VPU ] = {PORT_PEND, MSHR_BITS'(0), 1'b0, 1'b0, vpu_inv_i, CMO_NONE,   vpu_addr_i,  vpu_write_i,  vpu_in_i };
+
+        // a core CMO waits until the lookup FSM and the bus are idle with nothing buffered,
+        // the VPU / prefetch requests wait behind it (L2 takes one line invalidate at a time)
+        cmo_ready = (dcache_state_q == IDLE) && (bus_state_q == BUS_IDLE) && (mshr_size_q == (MSHR_BITS+1)'(0)) &&
+                    sb_empty && ~evict_q.valid && ~inv_busy_i;
+        cmo_wait  = (((port_n[REQ_CORE].state == PORT_PEND) && (port_n[REQ_CORE].cmo != CMO_NONE)) || snoop_q.valid) && ~cmo_ready;
+
+        // select the next request (snoop > core > vpu > prefetch)
+        // keep one MSHR for demand misses
+        snoop_pend = snoop_q.valid && cmo_ready;
+        core_pend  = (port_n[REQ_CORE].state == PORT_PEND) && ~cmo_wait;
+        vpu_pend   = (port_n[REQ_VPU ].state == PORT_PEND) && ~cmo_wait && ~(port_n[REQ_VPU].inv && (inv_busy_i || inv_req_o));
+        pf_pend    = (stride_valid_q || prefetch_q.valid) && (mshr_size_q < (MSHR_BITS+1)'(MSHR_NUM - 1)) && ~cmo_wait;
+        sel_valid  = snoop_pend || core_pend || vpu_pend || pf_pend;
+
+        if (snoop_pend) begin
+            sel_req = {1'b1, REQ_SNOOP, 1'b0, 1'b0, snoop_q.cmo, snoop_q.line, OFFSET_BITS'(0), 4'd0, 32'd0};
+        end else if (core_pend) begin
+            sel_req = {1'b1, REQ_CORE, port_n[REQ_CORE].replay, 1'b0, port_n[REQ_CORE].cmo, port_n[REQ_CORE].addr, port_n[REQ_CORE].write, port_n[REQ_CORE].data};
+        end else if (vpu_pend) begin
+            sel_req = {1'b1, REQ_VPU, port_n[REQ_VPU].replay, port_n[REQ_VPU].inv, CMO_NONE, port_n[REQ_VPU].addr, port_n[REQ_VPU].write, port_n[REQ_VPU].data};
+        end else if (stride_valid_q) begin
+            sel_req = {1'b1, REQ_PF, 1'b0, 1'b0, CMO_NONE, stride_line_q, OFFSET_BITS'(0), 4'd0, 32'd0};
+        end else begin
+            sel_req = {1'b1, REQ_PF, 1'b0, 1'b0, CMO_NONE, prefetch_q.line, OFFSET_BITS'(0), 4'd0, 32'd0};
+        end
+
+        // a filled line is written when the arrays are free, no new lookup until then
+        // (write-through: in IDLE, write-back / victim cache: in EVICT after the victim line is read out)
+        if (fill_write) begin
+            read_index = fill_index;
+            TA_in      = mshr_q[head_ptr_q].addr[31 -: TAG_BITS];
+            DA_in      = fill_data;
+
+            // the filled line replaces the PLRU way and becomes the most recently used
+            TA_write[victim_way] = 1'b1;
+            DA_write[victim_way] = {LINE_BYTES{1'b1}};
+            plru_touch           = 1'b1;
+            plru_set             = fill_index;
+            plru_way             = victim_way;
+
+            valid_n[fill_index][victim_way] = 1'b1;
+            dirty_n[fill_index][victim_way] = 1'b0;
+
+        // write-back / victim cache: read out the victim line first
+        end else if ((WRITE_BACK || VICTIM_CACHE) && (bus_state_q == BUS_FILL) && (dcache_state_q == IDLE)) begin
+            dcache_state_n = EVICT;
+            TA_read        = 1'b1;
+            DA_read        = 1'b1;
+            read_index     = fill_index;
+
+        // start the next lookup
+        end else if (accept && sel_valid && (bus_state_q != BUS_FILL)) begin
+            request_buffer_n = sel_req;
+            dcache_state_n   = (sel_req.src == REQ_PF)          ? (PREFETCH)   :
+                               (sel_req.cmo == CMO_CLEAN_ALL)   ? (WALK)       :
+                               (sel_req.cmo != CMO_NONE)        ? (MAINTAIN)   :
+                               (sel_req.inv)                    ? (INVALIDATE) :
+                               (|sel_req.core_write)            ? (WRITE)      : (READ);
+
+            if (sel_req.src == REQ_PF && stride_valid_q) begin
+                stride_taken     = 1'b1;
+            end else if (sel_req.src == REQ_PF) begin
+                prefetch_n.line  = prefetch_q.line + (32-OFFSET_BITS)'(1);
+                prefetch_n.valid = (prefetch_q.line != prefetch_q.end_line);
+            end else if (sel_req.src == REQ_SNOOP) begin
+                snoop_n.line     = snoop_q.line + (32-OFFSET_BITS)'(1);
+                snoop_n.valid    = (snoop_q.line != snoop_q.end_line);
+            end else begin
+                port_n[sel_req.src[0]].state = PORT_BUSY;
+            end
+
+            // set up tag/data array read
+            TA_read    = 1'b1;
+            DA_read    = (sel_req.src != REQ_PF);
+            read_index = sel_req.core_addr[OFFSET_BITS +: INDEX_BITS];
+
+            // a load only needs the column of its word, the others are left to the VPU hit port
+            // (a victim cache hit swaps the whole line with the PLRU way, it reads every column)
+            for (int i = 0; i < VC_NUM; i++) begin
+                if (VICTIM_CACHE && vc_q[i].valid && (vc_q[i].line == sel_req.core_addr[31:OFFSET_BITS])) sel_vc_hit = 1'b1;
+            end
+
+            if (DUAL_PORT && (COLS > 1) && (sel_req.src inside {REQ_CORE, REQ_VPU}) && ~(|sel_req.core_write) && ~sel_req.inv && (sel_req.cmo == CMO_NONE) && ~sel_vc_hit) begin
+                DA_col = COLS'(1) << sel_req.core_addr[3 +: COL_BITS];
+            end
+        end
+
+        // a refilled / swapped way may no longer hold the last VPU line
+        if (|TA_write) begin
+            vline_valid_n = 1'b0;
+        end
+
+        // columns the lookup FSM reads / writes in this cycle
+        for (int c = 0; c < COLS; c++) begin
+            main_col[c] = DA_read && DA_col[c];
+
+            for (int w = 0; w < WAYS; w++) begin
+                if (|DA_write[w][LINE_BYTES-1-c*8 -: 8]) main_col[c] = 1'b1;
+            end
+        end
+
+        // a VPU load the lookup FSM does not take reads its column on the VPU hit port
+        // when it is in the last line the VPU hit (the tag was checked then)
+        vport_col   = (COLS > 1) ? (port_n[REQ_VPU].addr[3 +: COL_BITS]) : (COL_BITS'(0));
+        vport_start = DUAL_PORT && (port_n[REQ_VPU].state == PORT_PEND) && ~port_n[REQ_VPU].slow && ~port_n[REQ_VPU].inv && ~(|port_n[REQ_VPU].write) &&
+                      vline_valid_q && vline_valid_n && (vline_q == port_n[REQ_VPU].addr[31:OFFSET_BITS]) && ~main_col[vport_col];
+
+        if (vport_start) begin
+            port_n[REQ_VPU].state = PORT_BUSY;
+        end
+
+        // the lookup FSM uses the PLRU port first
+        if (vport_valid_q && vport_hit && ~plru_touch) begin
+            plru_touch = 1'b1;
+            plru_set   = vport_index;
+            plru_way   = vline_way_q;
+        end
+
+        // the bus has sent out the write-back line
+        if (evict_done) begin
+            evict_n.valid = 1'b0;
+        end
+
+        // a new prefetch hint replaces the old one
+        if (pf_req_i) begin
+            prefetch_n = {1'b1, pf_addr_i[31:OFFSET_BITS], pf_end_i[31:OFFSET_BITS]};
+        end
+
+        // a DMA burst (the DMA waits for snoop_wait_o, one burst at a time)
+        if (snoop_req_i) begin
+            snoop_n = {1'b1, snoop_cmo_i, snoop_addr_i[31:OFFSET_BITS], snoop_end[31:OFFSET_BITS]};
+        end
+    end
+
+    // --------------------------------------------
+    //                  MSHR FIFO                  
+    // --------------------------------------------
+    // ---------------------------------------------------------------
+    // A miss takes an MSHR and leaves the lookup FSM, so hits (and
+    // misses to other lines) are served while the fill is in flight.
+    // Later requests to the same line wait on that MSHR and look up
+    // again when the line is written. Write-through and uncached
+    // accesses also go through the FIFO, so memory sees them in order.
+    // ---------------------------------------------------------------
+    assign mshr_full = (mshr_size_q == (MSHR_BITS+1)'(MSHR_NUM));
+
+    always_comb begin
+        mshr_n      = mshr_q;
+        mshr_size_n = mshr_size_q;
+        head_ptr_n  = head_ptr_q;
+        tail_ptr_n  = tail_ptr_q;
+
+        if (mshr_pop) begin
+            mshr_n[head_ptr_q].valid = 1'b0;
+            head_ptr_n               = (head_ptr_q == MSHR_BITS'(MSHR_NUM - 1)) ? (MSHR_BITS'(0)) : (head_ptr_q + MSHR_BITS'(1));
+        end
+
+        if (mshr_alloc) begin
+            mshr_n[tail_ptr_q] = mshr_entry;
+            tail_ptr_n         = (tail_ptr_q == MSHR_BITS'(MSHR_NUM - 1)) ? (MSHR_BITS'(0)) : (tail_ptr_q + MSHR_BITS'(1));
+        end
+
+        unique case ({mshr_alloc, mshr_pop})
+            2'b01   : mshr_size_n = mshr_size_q - (MSHR_BITS+1)'(1);
+            2'b10   : mshr_size_n = mshr_size_q + (MSHR_BITS+1)'(1);
+            default : ; // nothing to do
+        endcase
+    end
+
+    // --------------------------------------------
+    //                Victim Cache                 
+    // --------------------------------------------
+    // ---------------------------------------------------------------
+    // A line replaced by a fill moves to the victim cache, which is
+    // probed next to the tag array. A load that misses the cache but
+    // hits a victim swaps it with the PLRU way of its set, so lines
+    // of a few streams on the same index are not refetched. Stores
+    // write the victim in place, and in write-back mode a dirty
+    // victim is written back when it leaves the victim cache.
+    // ---------------------------------------------------------------
+    assign victim_set = (dcache_state_q == READ) ? (index) : (fill_index);
+
+    always_comb begin
+        vc_hit    = 1'b0;
+        vc_hit_id = VC_BITS'(0);
+
+        for (int i = 0; i < VC_NUM; i++) begin
+            if (VICTIM_CACHE && vc_q[i].valid && (vc_q[i].line == request_buffer_q.core_addr[31:OFFSET_BITS])) begin
+                vc_hit    = 1'b1;
+                vc_hit_id = VC_BITS'(i);
+            end
+        end
+
+        vc_data = vc_q[vc_hit_id].data[(LAST_WORD - word)*32 +: 32];
+    end
+
+    always_ff @(posedge clk_i) begin
+        if (rst_i) begin
+            foreach (vc_q[i]) begin
+                vc_q[i] <= VC_t'(0);
+            end
+
+            vc_ptr_q <= VC_BITS'(0);
+        end else begin
+            vc_q     <= vc_n;
+            vc_ptr_q <= vc_ptr_n;
+        end
+    end
+
+    // --------------------------------------------
+    //              Cache Maintenance              
+    // --------------------------------------------
+    // ---------------------------------------------------------------
+    // cbo.clean / cbo.flush write a dirty line back through the
+    // write-back buffer, cbo.inval / cbo.flush drop it here and in L2.
+    // A write to the cache invalidate CSR drops every line in one
+    // cycle. fence.i walks the dirty sets (lowest first) and writes
+    // them back one line at a time, the I$ refetches once the last
+    // write-back is in memory (cmo_busy_o is low). A DMA burst is
+    // snooped the same way, line by line through MAINTAIN, before it
+    // goes out (and again after a write, see DMA_wrapper).
+    // ---------------------------------------------------------------
+    assign cmo_busy_o = ((port_q[REQ_CORE].state != PORT_IDLE) && (port_q[REQ_CORE].cmo != CMO_NONE)) || evict_q.valid;
+
+    // DMA snoop: the burst waits until its lines are handled and the write-backs / L2 drops are done
+    assign snoop_end    = snoop_addr_i + {26'd0, snoop_len_i, 2'd0};
+    assign snoop_wait_o = snoop_req_i || snoop_q.valid || (request_buffer_q.valid && (request_buffer_q.src == REQ_SNOOP)) ||
+                          evict_q.valid || inv_busy_i;
+
+    always_comb begin
+        walk_found    = 1'b0;
+        walk_set      = INDEX_BITS'(0);
+        walk_vc_found = 1'b0;
+        walk_vc_id    = VC_BITS'(0);
+        walk_way      = WAY_BITS'(0);
+
+        for (int s = SETS-1; s >= 0; s--) begin
+            if (|(valid_q[s] & dirty_q[s])) begin
+                walk_found = 1'b1;
+                walk_set   = INDEX_BITS'(s);
+            end
+        end
+
+        for (int i = VC_NUM-1; i >= 0; i--) begin
+            if (VICTIM_CACHE && vc_q[i].valid && vc_q[i].dirty) begin
+                walk_vc_found = 1'b1;
+                walk_vc_id    = VC_BITS'(i);
+            end
+        end
+
+        for (int w = WAYS-1; w >= 0; w--) begin
+            if (valid_q[index][w] && dirty_q[index][w]) walk_way = WAY_BITS'(w);
+        end
+    end
+
+    // --------------------------------------------
+    //              Stride Prefetcher              
+    // --------------------------------------------
+    // ---------------------------------------------------------------
+    // Each core load (and store with write-back) trains the table
+    // entry of its pc with the distance to its last address. Once the
+    // same stride repeats, the line STRIDE_DIST strides ahead (at least
+    // the next line) goes to the lookup FSM as a prefetch, which fills
+    // it with a spare MSHR. A prefetch never leaves the 4 KiB page of
+    // the access, so it never reaches an unmapped address.
+    // ---------------------------------------------------------------
+    always_comb begin
+        rpt_n          = rpt_q;
+        stride_valid_n = stride_valid_q;
+        stride_line_n  = stride_line_q;
+
+        rpt_index      = core_pc_i[RPT_BITS+1:2];
+        rpt_stride     = core_addr_i - rpt_q[rpt_index].addr;
+        stride_addr    = core_addr_i + rpt_q[rpt_index].stride * STRIDE_DIST;
+        stride_line    = stride_addr[31:OFFSET_BITS];
+
+        // a small stride stays in the line --> the next line in its direction
+        if (stride_line == core_addr_i[31:OFFSET_BITS]) begin
+            stride_line = (rpt_q[rpt_index].stride[31]) ? (core_addr_i[31:OFFSET_BITS] - (32-OFFSET_BITS)'(1)) :
+                                                          (core_addr_i[31:OFFSET_BITS] + (32-OFFSET_BITS)'(1));
+        end
+
+        // the lookup FSM takes the prefetch
+        if (stride_taken) begin
+            stride_valid_n = 1'b0;
+        end
+
+        if (core_req_i && (core_cmo_i == CMO_NONE) && (WRITE_BACK || ~(|core_write_i))) begin
+            // new pc --> take the entry
+            if (!rpt_q[rpt_index].valid || (rpt_q[rpt_index].pc != core_pc_i)) begin
+                rpt_n[rpt_index] = {1'b1, core_pc_i, core_addr_i, 32'd0, 2'd0};
+
+            end else begin
+                rpt_n[rpt_index].addr = core_addr_i;
+
+                if (rpt_stride == rpt_q[rpt_index].stride) begin
+                    rpt_n[rpt_index].conf = (rpt_q[rpt_index].conf == 2'd3) ? (2'd3) : (rpt_q[rpt_index].conf + 2'd1);
+                end else if (rpt_q[rpt_index].conf[1]) begin
+                    rpt_n[rpt_index].conf = rpt_q[rpt_index].conf - 2'd1;
+                end else begin
+                    rpt_n[rpt_index].stride = rpt_stride;
+                    rpt_n[rpt_index].conf   = 2'd0;
+                end
+
+                // steady stride --> prefetch, but not the same line twice in a row
+                if ((rpt_stride == rpt_q[rpt_index].stride) && (rpt_q[rpt_index].conf != 2'd0) && (rpt_stride != 32'd0) &&
+                    (stride_line[31-OFFSET_BITS:12-OFFSET_BITS] == core_addr_i[31:12]) && (stride_line != stride_line_q)) begin
+                    stride_valid_n = 1'b1;
+                    stride_line_n  = stride_line;
+                end
+            end
+        end
+    end
+
+    always_ff @(posedge clk_i) begin
+        if (rst_i) begin
+            foreach (rpt_q[i]) begin
+                rpt_q[i] <= RPT_t'(0);
+            end
+
+            stride_valid_q <= 1'b0;
+            stride_line_q  <= (32-OFFSET_BITS)'(0);
+        end else begin
+            rpt_q          <= rpt_n;
+            stride_valid_q <= stride_valid_n;
+            stride_line_q  <= stride_line_n;
+        end
+    end
+
+    // --------------------------------------------
+    //                   Bus FSM                   
+    // --------------------------------------------
+    // ---------------------------------------------------------------
+    // master1 serves one transaction at a time. A dirty victim goes
+    // first, so a later fill of the same line reads the new data.
+    // Fills go before the store buffer (buffered stores are put on
+    // top of the fill line), uncached accesses wait until all the
+    // buffered stores are in memory. A line fill is a WRAP burst
+    // from the missing word, so the load waiting for it restarts
+    // after the first beat.
+    // ---------------------------------------------------------------
+    assign fill_index  = mshr_q[head_ptr_q].addr[OFFSET_BITS +: INDEX_BITS];
+    assign fill_first  = mshr_q[head_ptr_q].addr[2 +: WORD_BITS];
+    assign fill_word   = fill_first + fill_count_q;
+    assign fill_beat   = (bus_state_q == BUS_WAIT) && (mshr_q[head_ptr_q].op == MSHR_FILL) && D_out_valid_i;
+    assign fill_write  = (bus_state_q == BUS_FILL) && (dcache_state_q == ((WRITE_BACK || VICTIM_CACHE) ? (EVICT) : (IDLE)));
+    assign drain_start = (bus_state_q == BUS_IDLE) && ~evict_q.valid && ~sb_empty &&
+                         ~(mshr_q[head_ptr_q].valid && (mshr_q[head_ptr_q].op == MSHR_FILL));
+    assign sb_lock     = (bus_state_q == BUS_DRAIN) || drain_start;
 
-                        // store request info to buffer
-                        request_buffer_n = {1'b1, 1'b0, core_addr_i, core_write_i, core_in_i};
+    always_comb begin
+        // only the written words of the oldest line are sent (first beat always has a byte to write)
+        sb_first = LAST_WORD;
+        sb_last  = WORD_BITS'(0);
 
-                        // set up tag/data array read
-                        TA_read    = 1'b1;
-                        DA_read    = 1'b1;
-                        read_index = core_addr_i[`CACHE_INDEX];
+        for (int w = LINE_WORDS-1; w >= 0; w--) begin
+            if (|sb_q[sb_head_q].strb[(LINE_WORDS-1-w)*4 +: 4]) sb_first = WORD_BITS'(w);
+        end
 
-                    // receive vpu request
-                    end else if (vpu_request_i) begin
-                        // if core wirte != 0 -> read request
-                        dcache_state_n = (|vpu_write_i) ? (WRITE) : (READ);
+        for (int w = 0; w < LINE_WORDS; w++) begin
+            if (|sb_q[sb_head_q].strb[(LINE_WORDS-1-w)*4 +: 4]) sb_last = WORD_BITS'(w);
+        end
+    end
 
-                        // store request info to buffer
-                        request_buffer_n = {1'b1, 1'b1, vpu_addr_i, vpu_write_i, vpu_in_i};
+    always_comb begin
+        bus_state_n  = bus_state_q;
+        fill_line_n  = fill_line_q;
+        fill_count_n = fill_count_q;
+        mshr_pop     = 1'b0;
+        sb_pop       = 1'b0;
+        evict_done   = 1'b0;
 
-                        // set up tag/data array read
-                        TA_read    = 1'b1;
-                        DA_read    = 1'b1;
-                        read_index = vpu_addr_i[`CACHE_INDEX];
+        // default dcahce request assignment
+        D_req_o   = 1'b0;
+        D_write_o = (mshr_q[head_ptr_q].op == MSHR_WRITE) ? (mshr_q[head_ptr_q].strb) : (4'd0);
+        D_len_o   = (mshr_q[head_ptr_q].op == MSHR_FILL)  ? (4'(LINE_WORDS - 1)) : (4'd0);
+        D_addr_o  = mshr_q[head_ptr_q].addr;
+        D_in_o    = mshr_q[head_ptr_q].data;
+
+        // write-back line, word 0 at the top
+        if (bus_state_q == BUS_EVICT || (bus_state_q == BUS_IDLE && evict_q.valid)) begin
+            D_write_o = 4'hf;
+            D_len_o   = 4'(LINE_WORDS - 1);
+            D_addr_o  = evict_q.addr;
+            D_in_o    = evict_q.line[(LAST_WORD - fill_count_q)*32 +: 32];
+        end
+
+        // store buffer line, from the first to the last written word
+        if (sb_lock) begin
+            D_write_o = sb_q[sb_head_q].strb[(LAST_WORD - (sb_first + fill_count_q))*4  +: 4];
+            D_len_o   = 4'(sb_last - sb_first);
+            D_addr_o  = {sb_q[sb_head_q].line, sb_first, 2'd0};
+            D_in_o    = sb_q[sb_head_q].data[(LAST_WORD - (sb_first + fill_count_q))*32 +: 32];
+        end
+
+        unique case (bus_state_q)
+            BUS_IDLE : begin
+                if (evict_q.valid) begin
+                    D_req_o      = 1'b1;
+                    bus_state_n  = BUS_EVICT;
+                    fill_count_n = (D_in_ready_i) ? (WORD_BITS'(1)) : (WORD_BITS'(0));
+                end else if (mshr_q[head_ptr_q].valid && (mshr_q[head_ptr_q].op == MSHR_FILL)) begin
+                    D_req_o      = 1'b1;
+                    bus_state_n  = BUS_WAIT;
+                end else if (drain_start) begin
+                    D_req_o      = 1'b1;
+                    bus_state_n  = BUS_DRAIN;
+                    fill_count_n = (D_in_ready_i) ? (WORD_BITS'(1)) : (WORD_BITS'(0));
+                end else if (mshr_q[head_ptr_q].valid) begin
+                    D_req_o      = 1'b1;
+                    bus_state_n  = BUS_WAIT;
+                end
+            end
+
+            BUS_WAIT : begin
+                // read allocate (whole cache line to fill buffer, word 0 at the top, wraps around the line)
+                if (D_out_valid_i) begin
+                    fill_line_n[(LAST_WORD - fill_word)*32 +: 32] = D_out_i;
+                    fill_count_n                                  = fill_count_q + WORD_BITS'(1);
+
+                // the line is all in fill buffer, or single word access is finish
+                end else if (!D_wait_i) begin
+                    if (mshr_q[head_ptr_q].op == MSHR_FILL) begin
+                        bus_state_n = BUS_FILL;
+                    end else begin
+                        bus_state_n  = BUS_IDLE;
+                        mshr_pop     = 1'b1;
+                        fill_count_n = WORD_BITS'(0);
                     end
                 end
             end
 
-            default : dcache_state_n = IDLE;
+            BUS_FILL : begin
+                if (fill_write) begin
+                    bus_state_n = BUS_IDLE;
+                    mshr_pop    = 1'b1;
+                end
+            end
+
+            BUS_EVICT, BUS_DRAIN : begin
+                if (D_in_ready_i) begin
+                    fill_count_n = fill_count_q + WORD_BITS'(1);
+                end
+
+                if (!D_wait_i) begin
+                    bus_state_n  = BUS_IDLE;
+                    fill_count_n = WORD_BITS'(0);
+                    evict_done   = (bus_state_q == BUS_EVICT);
+                    sb_pop       = (bus_state_q == BUS_DRAIN);
+                end
+            end
+
+            default : bus_state_n = BUS_IDLE;
         endcase
     end
 
-    data_array_wrapper DA (
-        .CK   ( clk_i      ),
-        .CS   ( 1'b1       ),
-        .OE   ( DA_read    ),
-        .A    ( read_index ),
-        .WEB1 ( DA_write1  ),
-        .WEB2 ( DA_write2  ),
-        .DI   ( DA_in      ),
-        .DO1  ( DA_out1    ),
-        .DO2  ( DA_out2    )
+    // --------------------------------------------
+    //                 Store Buffer                
+    // --------------------------------------------
+    // ---------------------------------------------------------------
+    // Write-through stores are done once they are in the buffer, the
+    // store does not wait for the B channel. Stores to the same line
+    // are merged, so a line is written with a single burst.
+    // ---------------------------------------------------------------
+    assign sb_full    = (sb_size_q == (SB_BITS+1)'(SB_NUM));
+    assign sb_empty   = (sb_size_q == (SB_BITS+1)'(0));
+    assign sb_empty_o = sb_empty;
+
+    always_comb begin
+        sb_n      = sb_q;
+        sb_size_n = sb_size_q;
+        sb_head_n = sb_head_q;
+        sb_tail_n = sb_tail_q;
+
+        if (sb_pop) begin
+            sb_n[sb_head_q].valid = 1'b0;
+            sb_head_n             = (sb_head_q == SB_BITS'(SB_NUM - 1)) ? (SB_BITS'(0)) : (sb_head_q + SB_BITS'(1));
+        end
+
+        if (sb_write && sb_merge) begin
+            for (int b = 0; b < LINE_BYTES; b++) begin
+                if (store_strb[b]) sb_n[sb_merge_id].data[b*8 +: 8] = store_data[b*8 +: 8];
+            end
+
+            sb_n[sb_merge_id].strb = sb_q[sb_merge_id].strb | store_strb;
+
+        end else if (sb_write) begin
+            sb_n[sb_tail_q] = {1'b1, request_buffer_q.core_addr[31:OFFSET_BITS], store_data, store_strb};
+            sb_tail_n       = (sb_tail_q == SB_BITS'(SB_NUM - 1)) ? (SB_BITS'(0)) : (sb_tail_q + SB_BITS'(1));
+        end
+
+        unique case ({sb_write && ~sb_merge, sb_pop})
+            2'b01   : sb_size_n = sb_size_q - (SB_BITS+1)'(1);
+            2'b10   : sb_size_n = sb_size_q + (SB_BITS+1)'(1);
+            default : ; // nothing to do
+        endcase
+    end
+
+    always_ff @(posedge clk_i) begin
+        if (rst_i) begin
+            foreach (mshr_q[i]) begin
+                mshr_q[i] <= MSHR_t'(0);
+            end
+
+            mshr_size_q  <= (MSHR_BITS+1)'(0);
+            head_ptr_q   <= MSHR_BITS'(0);
+            tail_ptr_q   <= MSHR_BITS'(0);
+            bus_state_q  <= BUS_IDLE;
+            fill_line_q  <= LINE_BITS'(0);
+            fill_count_q <= WORD_BITS'(0);
+            evict_q      <= WB_BUF_t'(0);
+
+            foreach (sb_q[i]) begin
+                sb_q[i] <= SB_t'(0);
+            end
+
+            sb_size_q    <= (SB_BITS+1)'(0);
+            sb_head_q    <= SB_BITS'(0);
+            sb_tail_q    <= SB_BITS'(0);
+        end else begin
+            mshr_q       <= mshr_n;
+            mshr_size_q  <= mshr_size_n;
+            head_ptr_q   <= head_ptr_n;
+            tail_ptr_q   <= tail_ptr_n;
+            bus_state_q  <= bus_state_n;
+            fill_line_q  <= fill_line_n;
+            fill_count_q <= fill_count_n;
+            evict_q      <= evict_n;
+            sb_q         <= sb_n;
+            sb_size_q    <= sb_size_n;
+            sb_head_q    <= sb_head_n;
+            sb_tail_q    <= sb_tail_n;
+        end
+    end
+
+    // --------------------------------------------
+    //              Tag / Data Arrays              
+    // --------------------------------------------
+    // ---------------------------------------------------------------
+    // DUAL_PORT splits the data array into its columns (the 64-bit
+    // macros side by side in a line), each with its own address, so
+    // it is the same macros as one array. The lookup FSM takes the
+    // columns it reads / writes, the VPU hit port reads the column of
+    // its word from another one. The tag array is only used by the
+    // lookup FSM, the VPU hit port keeps the way of its last line.
+    // ---------------------------------------------------------------
+    always_ff @(posedge clk_i) begin
+        if (rst_i) begin
+            vport_valid_q <= 1'b0;
+            vline_valid_q <= 1'b0;
+            vline_q       <= (32-OFFSET_BITS)'(0);
+            vline_way_q   <= WAY_BITS'(0);
+            lookup_col_q  <= 1'b0;
+        end else begin
+            vport_valid_q <= vport_start;
+            vline_valid_q <= vline_valid_n;
+            vline_q       <= vline_n;
+            vline_way_q   <= vline_way_n;
+
+            if (DA_read) lookup_col_q <= (DA_col != {COLS{1'b1}});
+        end
+    end
+
+    generate
+        if (DUAL_PORT) begin : COL_ARRAY
+            always_comb begin
+                for (int c = 0; c < COLS; c++) begin
+                    if (main_col[c]) begin
+                        col_index[c] = read_index;
+                        col_read [c] = DA_read && DA_col[c];
+
+                        for (int w = 0; w < WAYS; w++) begin
+                            col_write[c][w] = DA_write[w][LINE_BYTES-1-c*8 -: 8];
+                        end
+                    end else begin
+                        col_index[c] = port_n[REQ_VPU].addr[OFFSET_BITS +: INDEX_BITS];
+                        col_read [c] = vport_start && (vport_col == COL_BITS'(c));
+                        col_write[c] = (WAYS*8)'(0);
+                    end
+                end
+            end
+
+            for (genvar c = 0; c < COLS; c++) begin : COL
+                data_array_wrapper #(
+                    .WAYS       ( WAYS       ),
+                    .SETS       ( SETS       ),
+                    .LINE_BYTES ( 8          )
+                ) DA (
+                    .CK  ( clk_i                        ),
+                    .CS  ( 1'b1                         ),
+                    .OE  ( col_read [c]                 ),
+                    .A   ( col_index[c]                 ),
+                    .WEB ( col_write[c]                 ),
+                    .DI  ( DA_in[LINE_BITS-1-c*64 -: 64] ),
+                    .DO  ( col_out  [c]                 )
+                );
+
+                for (genvar w = 0; w < WAYS; w++) begin : WAY
+                    assign DA_out[w][LINE_BITS-1-c*64 -: 64] = col_out[c][w];
+                end
+            end
+
+        end else begin : ONE_ARRAY
+            data_array_wrapper #(
+                .WAYS       ( WAYS       ),
+                .SETS       ( SETS       ),
+                .LINE_BYTES ( LINE_BYTES )
+            ) DA (
+                .CK  ( clk_i      ),
+                .CS  ( 1'b1       ),
+                .OE  ( DA_read    ),
+                .A   ( read_index ),
+                .WEB ( DA_write   ),
+                .DI  ( DA_in      ),
+                .DO  ( DA_out     )
+            );
+        end
+    endgenerate
+
+    tag_array_wrapper #(
+        .WAYS       ( WAYS       ),
+        .SETS       ( SETS       ),
+        .TAG_BITS   ( TAG_BITS   )
+    ) TA (
+        .CK  ( clk_i      ),
+        .CS  ( 1'b1       ),
+        .OE  ( TA_read    ),
+        .A   ( read_index ),
+        .DI  ( TA_in      ),
+        .WEB ( TA_write   ),
+        .DO  ( TA_out     )
     );
 
-    tag_array_wrapper TA (
-        .CK   ( clk_i      ),
-        .CS   ( 1'b1       ),
-        .OE   ( TA_read    ),
-        .A    ( read_index ),
-        .DI   ( TA_in      ),
-        .WEB1 ( TA_write1  ),
-        .WEB2 ( TA_write2  ),
-        .DO1  ( TA_out1    ),
-        .DO2  ( TA_out2    )
+    cache_plru #(
+        .WAYS         ( WAYS       ),
+        .SETS         ( SETS       )
+    ) PLRU (
+        .clk_i        ( clk_i      ),
+        .rst_i        ( rst_i      ),
+        .touch_i      ( plru_touch ),
+        .touch_set_i  ( plru_set   ),
+        .touch_way_i  ( plru_way   ),
+        .victim_set_i ( victim_set ),
+        .victim_way_o ( victim_way )
     );
 
     // --------------------------------------------
     //              Performance Counts             
     // --------------------------------------------
+    // a request is counted at its first lookup, not when it looks up again
     integer read_hit, read_miss;
     integer write_hit, write_miss;
+    integer prefetch_fill, stride_prefetch;
+    integer mshr_merge, hit_under_miss, early_restart;
+    integer dual_hit, victim_hit;
+    integer write_back, snoop_line;
+    integer store_merge, store_drain;
 
     always_ff @(posedge clk_i) begin
         if (rst_i) begin
-            read_hit   <= 0;
-            read_miss  <= 0;
-            write_hit  <= 0;
-            write_miss <= 0;
+            read_hit        <= 0;
+            read_miss       <= 0;
+            write_hit       <= 0;
+            write_miss      <= 0;
+            prefetch_fill   <= 0;
+            stride_prefetch <= 0;
+            mshr_merge      <= 0;
+            hit_under_miss  <= 0;
+            early_restart   <= 0;
+            dual_hit        <= 0;
+            victim_hit      <= 0;
+            write_back      <= 0;
+            snoop_line      <= 0;
+            store_merge     <= 0;
+            store_drain     <= 0;
         end else begin
-            if (dcache_state_q == READ) begin
-                if (hit1 || hit2) read_hit  <= read_hit  + 1;
-                else              read_miss <= read_miss + 1;
-            end
+            // the lookup FSM and the VPU hit port may both hit in a cycle
+            // a victim cache hit is a hit
+            read_hit <= read_hit + int'(dcache_state_q == READ && ~request_buffer_q.replay && (|hit || vc_hit)) + int'(vport_valid_q && vport_hit);
+
+            if (dcache_state_q == READ && ~request_buffer_q.replay && ~(|hit || vc_hit)) read_miss <= read_miss + 1;
+
+            if (vport_valid_q && vport_hit) dual_hit <= dual_hit + 1;
 
-            if (dcache_state_q == WRITE) begin
-                if (hit1 || hit2) write_hit  <= write_hit  + 1;
-                else              write_miss <= write_miss + 1;
+            if (dcache_state_q == WRITE && ~request_buffer_q.replay) begin
+                if (|hit || vc_hit) write_hit  <= write_hit  + 1;
+                else                write_miss <= write_miss + 1;
             end
+
+            if ((dcache_state_q == READ || dcache_state_q == WRITE) && ~request_buffer_q.replay && ~(|hit) && vc_hit) victim_hit <= victim_hit + 1;
+
+            if ((dcache_state_q == READ || dcache_state_q == WRITE) && mshr_match) mshr_merge <= mshr_merge + 1;
+
+            if (dcache_state_q == READ && (|hit) && (bus_state_q != BUS_IDLE)) hit_under_miss <= hit_under_miss + 1;
+
+            if (restart) early_restart <= early_restart + 1;
+
+            if (dcache_state_q == PREFETCH && mshr_alloc) prefetch_fill <= prefetch_fill + 1;
+            if (stride_taken)                             stride_prefetch <= stride_prefetch + 1;
+
+            if (evict_done) write_back <= write_back + 1;
+
+            if (dcache_state_q == MAINTAIN && request_buffer_q.src == REQ_SNOOP) snoop_line <= snoop_line + 1;
+
+            if (sb_write && sb_merge) store_merge <= store_merge + 1;
+            if (sb_pop)               store_drain <= store_drain + 1;
         end
     end
 
@@ -385,6 +1616,24 @@ module L1C_data (
 		$display("TOTAL L1CD Hit  Count = %0d", (read_hit +  write_hit ));
 		$display("TOTAL L1CD Miss Count = %0d", (read_miss + write_miss));
 		$display("TOTAL L1CD Hit  Rate  = %0.2f%%", L1CD_Hit__Rate);
+		// Prefetch
+		$display("PREFETCH L1CD Fill Count = %0d", prefetch_fill);
+		$display("PREFETCH L1CD Stride Count = %0d", stride_prefetch);
+		// MSHR
+		$display("MSHR L1CD Merge Count = %0d", mshr_merge);
+		$display("MSHR L1CD Hit Under Miss Count = %0d", hit_under_miss);
+		$display("MSHR L1CD Early Restart Count = %0d", early_restart);
+		// Dual port
+		$display("DUAL PORT L1CD VPU Hit Count = %0d", dual_hit);
+		// Victim cache
+		$display("VICTIM L1CD Hit Count = %0d", victim_hit);
+		// Write-back
+		$display("WRITE-BACK L1CD Evict Count = %0d", write_back);
+		// DMA snoop
+		$display("SNOOP L1CD Line Count = %0d", snoop_line);
+		// Store buffer
+		$display("STORE BUFFER L1CD Merge Count = %0d", store_merge);
+		$display("STORE BUFFER L1CD Burst Count = %0d", store_drain);
 	end
 
 endmodule
\ No newline at end of file
@@ -9,49 +9,112 @@ module L1C_inst (
     output logic [31:0] core_addr_o,
     output logic [31:0] core_out_o,
 
+    // fetch is redirected to a BTB-predicted target
+    input  logic        pf_req_i,
+    input  logic [31:0] pf_addr_i,
+
+    // fence.i: drop every line once the D$ write-backs are in memory
+    input  logic        inv_req_i,
+    input  logic        inv_hold_i,  // D$ is still writing the dirty lines back
+
     // D$ <-> master0
     output logic        D_req_o,
-    output logic [31:0] D_addr_o,
+    output logic [ 3:0] D_len_o,    // burst length - 1 (LINE_WORDS-1)
+    output logic [31:0] D_addr_o,   // a demand fill starts at the missing word (WRAP burst)
     input  logic        D_wait_i,
     input  logic        D_out_valid_i,
     input  logic [31:0] D_out_i
 );
 
+    // cache geometry (see def.svh)
+    parameter int WAYS       = ICACHE_WAYS;
+    parameter int SETS       = ICACHE_SETS;
+    parameter int LINE_BYTES = ICACHE_LINE_BYTES;
+
+    // prefetch buffer lines, the stream runs up to PF_NUM lines ahead
+    parameter int PF_NUM     = 2;
+
+    localparam int PF_BITS     = (PF_NUM > 1) ? $clog2(PF_NUM) : 1;
+    localparam int WAY_BITS    = $clog2(WAYS);
+    localparam int INDEX_BITS  = $clog2(SETS);
+    localparam int OFFSET_BITS = $clog2(LINE_BYTES);
+    localparam int TAG_BITS    = 32 - INDEX_BITS - OFFSET_BITS;
+    localparam int LINE_BITS   = LINE_BYTES * 8;
+    localparam int LINE_WORDS  = LINE_BYTES / 4;
+    localparam int WORD_BITS   = $clog2(LINE_WORDS);
+
+    localparam logic [WORD_BITS-1:0] LAST_WORD = WORD_BITS'(LINE_WORDS - 1);
+
     // --------------------------------------------
     //              Signal Declaration             
     // --------------------------------------------
     typedef enum logic [1:0] {
         IDLE,       // accept a read/write request from core
         READ,       // read the data from cache line
-        WAIT_AXI    // wait for axi transfer
+        WAIT_AXI,   // wait for axi transfer
+        FENCE       // fence.i, wait for D$ and the prefetch on master0, then drop every line
     } CACHE_STATE_t;
 
     typedef struct packed {
-        logic        valid;
-        logic [31:0] core_addr;
-        logic [ 3:0] core_count;
-        logic [31:0] core_out;
+        logic                 valid;
+        logic [31:0]          core_addr;
+        logic [WORD_BITS-1:0] core_count; // word of the next beat
+        logic [WAY_BITS -1:0] fill_way;   // the way being filled
+        logic [31:0]          core_out;
     } REQ_BUF_t;
 
-    CACHE_STATE_t                 icache_state_q, icache_state_n;
-    REQ_BUF_t                     request_buffer_q, request_buffer_n;
-
-    logic [`CACHE_WRITE_BITS-1:0] DA_write1, DA_write2;
-    logic [`CACHE_DATA_BITS -1:0] DA_in;
-    logic                         DA_read;
-    logic [`CACHE_DATA_BITS -1:0] DA_out1, DA_out2;
-    logic [31:0]                  read_data1, read_data2;
-
-    logic                         TA_write1, TA_write2;
-    logic [`CACHE_TAG_BITS  -1:0] TA_in;
-    logic                         TA_read;
-    logic [`CACHE_TAG_BITS  -1:0] TA_out1, TA_out2;
-
-    logic [`CACHE_INDEX_BITS-1:0] index, read_index;    // address to tag/data array
-    logic [`CACHE_LINES     -1:0] valid1_q, valid1_n;   // valid bit of each cache line (way1)
-    logic [`CACHE_LINES     -1:0] valid2_q, valid2_n;   // valid bit of each cache line (way2)
-    logic [`CACHE_LINES     -1:0] replace_q, replace_n; // the way to replace
-    logic                         hit1, hit2;
+    // prefetch buffer line
+    typedef struct packed {
+        logic                     valid;
+        logic                     ready;  // the whole line is in the buffer
+        logic [31-OFFSET_BITS :0] line;
+        logic [LINE_BITS    -1:0] data;
+    } PF_LINE_t;
+
+    CACHE_STATE_t                    icache_state_q, icache_state_n;
+    REQ_BUF_t                        request_buffer_q, request_buffer_n;
+
+    // next-N-line prefetcher
+    PF_LINE_t                        pf_buf_q[PF_NUM], pf_buf_n[PF_NUM];
+    logic [31-OFFSET_BITS :0]        stream_q, stream_n;     // next line to prefetch
+    logic [PF_BITS        :0]        credit_q, credit_n;     // lines the stream may still run ahead
+    logic                            pf_busy_q, pf_busy_n;   // master0 is filling a prefetch line
+    logic [PF_BITS      -1:0]        pf_id_q, pf_id_n;       // the buffer line being filled
+    logic [WORD_BITS    -1:0]        pf_count_q, pf_count_n;
+    logic                            pf_match;               // the demand line is in the buffer
+    logic [PF_BITS      -1:0]        pf_match_id;
+    logic                            pf_free;                // a buffer line is free
+    logic [PF_BITS      -1:0]        pf_free_id;
+    logic                            pf_present;             // the stream line is already in the buffer
+    logic                            pf_redirect;            // BTB target line is not in the stream
+    logic                            pf_issue;
+    logic                            pf_use;                 // the demand line leaves the buffer
+    logic                            demand_miss;            // demand fill goes to master0
+
+    // fence.i, a fetch after it waits until the lines are dropped
+    logic                            inv_pend_q, inv_pend_n;
+    logic                            inv_done;
+
+    logic [WAYS-1:0][LINE_BYTES-1:0] DA_write;
+    logic [LINE_BITS   -1:0]         DA_in;
+    logic                            DA_read;
+    logic [WAYS-1:0][LINE_BITS -1:0] DA_out;
+    logic [31:0]                     hit_data;
+
+    logic [WAYS        -1:0]         TA_write;
+    logic [TAG_BITS    -1:0]         TA_in;
+    logic                            TA_read;
+    logic [WAYS-1:0][TAG_BITS  -1:0] TA_out;
+
+    logic [INDEX_BITS  -1:0]         index, read_index;    // address to tag/data array
+    logic [SETS-1:0][WAYS-1:0]       valid_q, valid_n;     // valid bit of each way of each set
+    logic [WAYS        -1:0]         hit;                  // hit way (one-hot)
+    logic [WAY_BITS    -1:0]         hit_way;
+
+    // tree-PLRU update (a hit, or a miss taking the victim way)
+    logic                            plru_touch;
+    logic [WAY_BITS    -1:0]         plru_way;
+    logic [WAY_BITS    -1:0]         victim_way;
 
     // --------------------------------------------
     //               Dcache Controller             
@@ -60,51 +123,57 @@ module L1C_inst (
         if (rst_i) begin
             icache_state_q   <= IDLE;
             request_buffer_q <= REQ_BUF_t'(0);
-            valid1_q         <= 32'd0;
-            valid2_q         <= 32'd0;
-            replace_q        <= 32'd0;
+            valid_q          <= (SETS*WAYS)'(0);
+            inv_pend_q       <= 1'b0;
         end else begin
             icache_state_q   <= icache_state_n;
             request_buffer_q <= request_buffer_n;
-            valid1_q         <= valid1_n;
-            valid2_q         <= valid2_n;
-            replace_q        <= replace_n;
+            valid_q          <= valid_n;
+            inv_pend_q       <= inv_pend_n;
         end
     end
 
     always_comb begin
-        index = request_buffer_q.core_addr[`CACHE_INDEX];
-        hit1  = valid1_q[index] && (TA_out1 == request_buffer_q.core_addr[`CACHE_TAG]);
-        hit2  = valid2_q[index] && (TA_out2 == request_buffer_q.core_addr[`CACHE_TAG]);
-
-        case (request_buffer_q.core_addr[`CACHE_OFFEST])
-            2'b00   : {read_data1, read_data2} = {DA_out1[127:96], DA_out2[127:96]};
-            2'b01   : {read_data1, read_data2} = {DA_out1[95 :64], DA_out2[95 :64]};
-            2'b10   : {read_data1, read_data2} = {DA_out1[63 :32], DA_out2[63 :32]};
-            2'b11   : {read_data1, read_data2} = {DA_out1[31 : 0], DA_out2[31 : 0]};
-        endcase
+        index    = request_buffer_q.core_addr[OFFSET_BITS +: INDEX_BITS];
+        hit      = WAYS'(0);
+        hit_way  = WAY_BITS'(0);
+        hit_data = 32'd0;
+
+        // word 0 is at the top of the line
+        for (int w = 0; w < WAYS; w++) begin
+            if (valid_q[index][w] && (TA_out[w] == request_buffer_q.core_addr[31 -: TAG_BITS])) begin
+                hit[w]   = 1'b1;
+                hit_way  = WAY_BITS'(w);
+                hit_data = DA_out[w][(LAST_WORD - request_buffer_q.core_addr[2 +: WORD_BITS])*32 +: 32];
+            end
+        end
     end
 
     always_comb begin
         icache_state_n   = icache_state_q;
         request_buffer_n = request_buffer_q;
-        valid1_n         = valid1_q;
-        valid2_n         = valid2_q;
-        replace_n        = replace_q;
+        valid_n          = valid_q;
+        pf_use           = 1'b0;
+        demand_miss      = 1'b0;
+        inv_pend_n       = inv_pend_q | inv_req_i;
+        inv_done         = 1'b0;
 
         // default TA / DA assignment
         read_index = index;
         TA_read    = 1'b0;
-        TA_write1  = 1'b0;
-        TA_write2  = 1'b0;
-        TA_in      = request_buffer_q.core_addr[`CACHE_TAG];
+        TA_write   = WAYS'(0);
+        TA_in      = request_buffer_q.core_addr[31 -: TAG_BITS];
         DA_read    = 1'b0;
-        DA_write1  = 16'd0;
-        DA_write2  = 16'd0;
-        DA_in      = {D_out_i, 96'd0} >> ({request_buffer_q.core_count, 5'd0});
+        DA_write   = (WAYS*LINE_BYTES)'(0);
+        DA_in      = {D_out_i, (LINE_BITS-32)'(0)} >> ({request_buffer_q.core_count, 5'd0});
+
+        // a hit is the most recently used way of the set
+        plru_touch = 1'b0;
+        plru_way   = hit_way;
 
         // default dcahce request assignment
         D_req_o   = 1'b0;
+        D_len_o   = 4'(LINE_WORDS - 1);
         D_addr_o  = request_buffer_q.core_addr;
 
         // default core request assignmnet
@@ -119,22 +188,25 @@ module L1C_inst (
                     icache_state_n = READ;
 
                     // store request info to buffer
-                    request_buffer_n = {1'b1, core_pc_i, 4'd0, 32'd0};
+                    request_buffer_n = {1'b1, core_pc_i, WORD_BITS'(0), WAY_BITS'(0), 32'd0};
 
                     // set up tag/data array read
                     TA_read    = 1'b1;
                     DA_read    = 1'b1;
-                    read_index = core_pc_i[`CACHE_INDEX];
+                    read_index = core_pc_i[OFFSET_BITS +: INDEX_BITS];
                 end
             end
 
             READ : begin
                 // if hit -> just read out
-                if (hit1 || hit2) begin
+                if (|hit) begin
                     icache_state_n            = IDLE;
                     request_buffer_n.valid    = 1'b0;
-                    request_buffer_n.core_out = (hit1) ? (read_data1) : (read_data2);
-                    replace_n[index]          = (hit1) ? (1'b1) : (1'b0);
+                    request_buffer_n.core_out = hit_data;
+                    plru_touch                = 1'b1;
+
+                    // the line was prefetched while it is in the cache, drop the copy
+                    pf_use      = pf_match;
 
                     // send data back to core earlier
                     core_wait_o = 1'b0;
@@ -145,113 +217,327 @@ module L1C_inst (
                         icache_state_n = READ;
 
                         // store request info to buffer
-                        request_buffer_n = {1'b1, core_pc_i, 4'd0, 32'd0};
+                        request_buffer_n = {1'b1, core_pc_i, WORD_BITS'(0), WAY_BITS'(0), 32'd0};
 
                         // set up tag/data array read
                         TA_read    = 1'b1;
                         DA_read    = 1'b1;
-                        read_index = core_pc_i[`CACHE_INDEX];
+                        read_index = core_pc_i[OFFSET_BITS +: INDEX_BITS];
                     end
 
+                // prefetched --> move the whole line into the PLRU way (no new request this cycle)
+                end else if (pf_match && pf_buf_q[pf_match_id].ready) begin
+                    icache_state_n            = IDLE;
+                    request_buffer_n.valid    = 1'b0;
+                    request_buffer_n.core_out = pf_buf_q[pf_match_id].data[(LAST_WORD - request_buffer_q.core_addr[2 +: WORD_BITS])*32 +: 32];
+                    pf_use                    = 1'b1;
+
+                    TA_write[victim_way]       = 1'b1;
+                    DA_write[victim_way]       = {LINE_BYTES{1'b1}};
+                    DA_in                      = pf_buf_q[pf_match_id].data;
+                    valid_n[index][victim_way] = 1'b1;
+                    plru_touch                 = 1'b1;
+                    plru_way                   = victim_way;
+
+                    core_wait_o = 1'b0;
+                    core_out_o  = request_buffer_n.core_out;
+
+                // the line (or another prefetch) is on master0 --> wait for it
+                end else if (pf_match || pf_busy_q) begin
+                    icache_state_n = READ;
+
                 // not hit --> read allocate
                 end else begin
                     // send out read request to master
                     icache_state_n = WAIT_AXI;
+                    demand_miss    = 1'b1;
                     D_req_o        = 1'b1;
-                    D_addr_o       = {request_buffer_q.core_addr[31:4], 4'd0};
-
-                    // set up tag array write request
-                    TA_write1        = ~replace_q[index];
-                    TA_write2        =  replace_q[index];
-                    valid1_n[index]  = (TA_write1) ? (1'b1) : valid1_q[index];
-                    valid2_n[index]  = (TA_write2) ? (1'b1) : valid2_q[index];
-                    replace_n[index] = ~replace_q[index];
+                    D_addr_o       = {request_buffer_q.core_addr[31:2], 2'd0};
+
+                    // set up tag array write request, the line replaces the PLRU way
+                    TA_write[victim_way]        = 1'b1;
+                    valid_n[index][victim_way]  = 1'b1;
+                    plru_touch                  = 1'b1;
+                    plru_way                    = victim_way;
+                    request_buffer_n.fill_way   = victim_way;
+                    request_buffer_n.core_count = request_buffer_q.core_addr[2 +: WORD_BITS];
                 end
             end
 
             WAIT_AXI : begin
-                // read allocate (whole cache line to wrire)
+                // read allocate (whole cache line to wrire, from the missing word and wraps around the line)
                 if (D_out_valid_i) begin
-                    // set up data array write request, replace_q is already updated in read state
-                    // --> when replace_q is way 1 (1'b0), we need to write data in way2
-                    // --> when replace_q is way 2 (1'b1), we need to write data in way1
-                    if (replace_q[index] == 1'b0) begin
-                        DA_write2 = 16'hf000 >> ({request_buffer_q.core_count, 2'd0});
-                    end else begin
-                        DA_write1 = 16'hf000 >> ({request_buffer_q.core_count, 2'd0});
-                    end
+                    // set up data array write request in the way chosen in read state
+                    DA_write[request_buffer_q.fill_way] = {4'hf, (LINE_BYTES-4)'(0)} >> ({request_buffer_q.core_count, 2'd0});
 
-                    // use core_wrire to indicate how many words we have read
-                    request_buffer_n.core_count = request_buffer_q.core_count + 4'd1;
-                    
-                    // store the read data for core in request buffer
-                    if (request_buffer_q.core_count[1:0] == request_buffer_q.core_addr[3:2]) begin
+                    // use core_count to indicate which word we are reading
+                    request_buffer_n.core_count = request_buffer_q.core_count + WORD_BITS'(1);
+
+                    // early restart: the first beat is the missing word, send it to core right now
+                    // (not after fence.i, the line may be older than the D$ write-backs)
+                    if (request_buffer_q.valid && !inv_pend_n) begin
+                        request_buffer_n.valid    = 1'b0;
                         request_buffer_n.core_out = D_out_i;
+
+                        core_wait_o = 1'b0;
+                        core_out_o  = D_out_i;
+
+                    // the next fetch in the line takes its word when it arrives
+                    end else if (core_req_i && !inv_pend_n && (core_pc_i[31:2] == {request_buffer_q.core_addr[31:OFFSET_BITS], request_buffer_q.core_count})) begin
+                        request_buffer_n.core_out = D_out_i;
+
+                        core_wait_o = 1'b0;
+                        core_addr_o = core_pc_i;
+                        core_out_o  = D_out_i;
                     end
 
-                // the data is all writen in data array
+                // the data is all writen in data array (core already has its word)
                 end else if (!D_wait_i) begin
-                    icache_state_n         = IDLE;
-                    request_buffer_n.valid = 1'b0;
-                    core_wait_o            = 1'b0;
+                    icache_state_n = IDLE;
 
                     // receive next read/write request
                     if (core_req_i) begin
                         icache_state_n = READ;
 
                         // store request info to buffer
-                        request_buffer_n = {1'b1, core_pc_i, 4'd0, 32'd0};
+                        request_buffer_n = {1'b1, core_pc_i, WORD_BITS'(0), WAY_BITS'(0), 32'd0};
 
                         // set up tag/data array read
                         TA_read    = 1'b1;
                         DA_read    = 1'b1;
-                        read_index = core_pc_i[`CACHE_INDEX];
+                        read_index = core_pc_i[OFFSET_BITS +: INDEX_BITS];
                     end
                 end
             end
 
+            FENCE : begin
+                // the prefetch line in flight is dropped too
+                if (!pf_busy_q && !inv_hold_i) begin
+                    icache_state_n = IDLE;
+                    valid_n        = (SETS*WAYS)'(0);
+                    inv_pend_n     = 1'b0;
+                    inv_done       = 1'b1;
+                end
+            end
+
             default : ; // nothing to do
         endcase
+
+        // fence.i --> the fetch in the buffer is refetched after the lines are dropped
+        // (a demand fill on master0 finishes first)
+        if (inv_pend_n && (icache_state_n != WAIT_AXI) && !inv_done) begin
+            icache_state_n         = FENCE;
+            request_buffer_n.valid = 1'b0;
+        end
+
+        // send the next prefetch line when master0 is free
+        if (pf_issue) begin
+            D_req_o  = 1'b1;
+            D_addr_o = {stream_q, OFFSET_BITS'(0)};
+        end
     end
 
-    data_array_wrapper DA (
-        .CK   ( clk_i      ),
-        .CS   ( 1'b1       ),
-        .OE   ( DA_read    ),
-        .A    ( read_index ),
-        .WEB1 ( DA_write1  ),
-        .WEB2 ( DA_write2  ),
-        .DI   ( DA_in      ),
-        .DO1  ( DA_out1    ),
-        .DO2  ( DA_out2    )
+    // --------------------------------------------
+    //             Next-N-Line Prefetch            
+    // --------------------------------------------
+    // ---------------------------------------------------------------
+    // A demand miss starts a stream at the next line, which fills
+    // the prefetch buffer while the core runs on cache hits. A line
+    // taken from the buffer lets the stream run one more line ahead.
+    // A BTB-predicted taken branch moves a running stream to the
+    // lines after the target. The stream stops at a 4 KiB boundary,
+    // so it never leaves the memory of the missing line.
+    // ---------------------------------------------------------------
+    always_comb begin
+        pf_match    = 1'b0;
+        pf_match_id = PF_BITS'(0);
+        pf_free     = 1'b0;
+        pf_free_id  = PF_BITS'(0);
+        pf_present  = 1'b0;
+        pf_redirect = pf_req_i && (credit_q != (PF_BITS+1)'(0)) && (pf_addr_i[31:OFFSET_BITS] + (32-OFFSET_BITS)'(1) != stream_q);
+
+        for (int i = 0; i < PF_NUM; i++) begin
+            if (pf_buf_q[i].valid && (pf_buf_q[i].line == request_buffer_q.core_addr[31:OFFSET_BITS])) begin
+                pf_match    = 1'b1;
+                pf_match_id = PF_BITS'(i);
+            end
+
+            if (pf_buf_q[i].valid && (pf_buf_q[i].line == stream_q)) begin
+                pf_present  = 1'b1;
+            end
+
+            if (pf_buf_q[i].valid && (pf_buf_q[i].line == pf_addr_i[31:OFFSET_BITS] + (32-OFFSET_BITS)'(1))) begin
+                pf_redirect = 1'b0;
+            end
+
+            if (!pf_buf_q[i].valid) begin
+                pf_free     = 1'b1;
+                pf_free_id  = PF_BITS'(i);
+            end
+        end
+
+        // master0 is only free when neither the demand fill nor a prefetch uses it
+        pf_issue = (credit_q != (PF_BITS+1)'(0)) && pf_free && ~pf_present && ~pf_busy_q && ~demand_miss && (icache_state_q != WAIT_AXI) && ~inv_pend_q;
+    end
+
+    always_comb begin
+        pf_buf_n   = pf_buf_q;
+        stream_n   = stream_q;
+        credit_n   = credit_q;
+        pf_busy_n  = pf_busy_q;
+        pf_id_n    = pf_id_q;
+        pf_count_n = pf_count_q;
+
+        // prefetch line from master0 (word 0 at the top)
+        if (pf_busy_q) begin
+            if (D_out_valid_i) begin
+                pf_buf_n[pf_id_q].data[(LAST_WORD - pf_count_q)*32 +: 32] = D_out_i;
+                pf_count_n                                                 = pf_count_q + WORD_BITS'(1);
+            end else if (!D_wait_i) begin
+                pf_buf_n[pf_id_q].ready = 1'b1;
+                pf_busy_n               = 1'b0;
+                pf_count_n              = WORD_BITS'(0);
+            end
+        end
+
+        // the core reached a prefetched line --> one more line ahead
+        if (pf_use) begin
+            pf_buf_n[pf_match_id].valid = 1'b0;
+            credit_n                    = (credit_q == (PF_BITS+1)'(PF_NUM)) ? (credit_q) : (credit_q + (PF_BITS+1)'(1));
+        end
+
+        // the stream line is already in the buffer --> skip it
+        if (credit_q != (PF_BITS+1)'(0) && pf_present) begin
+            stream_n = stream_q + (32-OFFSET_BITS)'(1);
+            credit_n = credit_n - (PF_BITS+1)'(1);
+        end
+
+        if (pf_issue) begin
+            pf_buf_n[pf_free_id] = {1'b1, 1'b0, stream_q, LINE_BITS'(0)};
+            stream_n             = stream_q + (32-OFFSET_BITS)'(1);
+            credit_n             = credit_n - (PF_BITS+1)'(1);
+            pf_busy_n            = 1'b1;
+            pf_id_n              = pf_free_id;
+        end
+
+        // a taken branch leaves the stream --> follow the target, the fall-through lines are useless
+        if (pf_redirect) begin
+            foreach (pf_buf_n[i]) begin
+                pf_buf_n[i].valid = 1'b0;
+            end
+
+            stream_n = pf_addr_i[31:OFFSET_BITS] + (32-OFFSET_BITS)'(1);
+            credit_n = (PF_BITS+1)'(PF_NUM);
+        end
+
+        // a demand miss --> restart the stream after the missing line
+        if (demand_miss) begin
+            foreach (pf_buf_n[i]) begin
+                pf_buf_n[i].valid = 1'b0;
+            end
+
+            stream_n = request_buffer_q.core_addr[31:OFFSET_BITS] + (32-OFFSET_BITS)'(1);
+            credit_n = (PF_BITS+1)'(PF_NUM);
+        end
+
+        // fence.i --> the prefetched lines may be stale, the stream restarts at the next miss
+        if (inv_done) begin
+            foreach (pf_buf_n[i]) begin
+                pf_buf_n[i].valid = 1'b0;
+            end
+
+            credit_n = (PF_BITS+1)'(0);
+        end
+
+        // never cross a 4 KiB boundary
+        if (stream_n[11-OFFSET_BITS:0] == (12-OFFSET_BITS)'(0)) begin
+            credit_n = (PF_BITS+1)'(0);
+        end
+    end
+
+    always_ff @(posedge clk_i) begin
+        if (rst_i) begin
+            foreach (pf_buf_q[i]) begin
+                pf_buf_q[i] <= PF_LINE_t'(0);
+            end
+
+            stream_q   <= (32-OFFSET_BITS)'(0);
+            credit_q   <= (PF_BITS+1)'(0);
+            pf_busy_q  <= 1'b0;
+            pf_id_q    <= PF_BITS'(0);
+            pf_count_q <= WORD_BITS'(0);
+        end else begin
+            pf_buf_q   <= pf_buf_n;
+            stream_q   <= stream_n;
+            credit_q   <= credit_n;
+            pf_busy_q  <= pf_busy_n;
+            pf_id_q    <= pf_id_n;
+            pf_count_q <= pf_count_n;
+        end
+    end
+
+    data_array_wrapper #(
+        .WAYS       ( WAYS       ),
+        .SETS       ( SETS       ),
+        .LINE_BYTES ( LINE_BYTES )
+    ) DA (
+        .CK  ( clk_i      ),
+        .CS  ( 1'b1       ),
+        .OE  ( DA_read    ),
+        .A   ( read_index ),
+        .WEB ( DA_write   ),
+        .DI  ( DA_in      ),
+        .DO  ( DA_out     )
     );
 
-    tag_array_wrapper TA (
-        .CK   ( clk_i      ),
-        .CS   ( 1'b1       ),
-        .OE   ( TA_read    ),
-        .A    ( read_index ),
-        .DI   ( TA_in      ),
-        .WEB1 ( TA_write1  ),
-        .WEB2 ( TA_write2  ),
-        .DO1  ( TA_out1    ),
-        .DO2  ( TA_out2    )
+    tag_array_wrapper #(
+        .WAYS       ( WAYS       ),
+        .SETS       ( SETS       ),
+        .TAG_BITS   ( TAG_BITS   )
+    ) TA (
+        .CK  ( clk_i      ),
+        .CS  ( 1'b1       ),
+        .OE  ( TA_read    ),
+        .A   ( read_index ),
+        .DI  ( TA_in      ),
+        .WEB ( TA_write   ),
+        .DO  ( TA_out     )
+    );
+
+    cache_plru #(
+        .WAYS         ( WAYS       ),
+        .SETS         ( SETS       )
+    ) PLRU (
+        .clk_i        ( clk_i      ),
+        .rst_i        ( rst_i      ),
+        .touch_i      ( plru_touch ),
+        .touch_set_i  ( index      ),
+        .touch_way_i  ( plru_way   ),
+        .victim_set_i ( index      ),
+        .victim_way_o ( victim_way )
     );
 
     // --------------------------------------------
     //              Performance Counts             
     // --------------------------------------------
+    // a miss is counted when it leaves READ (a buffer hit is still a cache miss)
     integer read_hit, read_miss;
+    integer prefetch_fill, prefetch_hit;
 
     always_ff @(posedge clk_i) begin
         if (rst_i) begin
-            read_hit   <= 0;
-            read_miss  <= 0;
+            read_hit      <= 0;
+            read_miss     <= 0;
+            prefetch_fill <= 0;
+            prefetch_hit  <= 0;
         end else begin
             if (icache_state_q == READ) begin
-                if (hit1 || hit2) read_hit  <= read_hit  + 1;
-                else              read_miss <= read_miss + 1;
+                if (|hit)                       read_hit  <= read_hit  + 1;
+                else if (demand_miss || pf_use) read_miss <= read_miss + 1;
             end
+
+            if (pf_issue)          prefetch_fill <= prefetch_fill + 1;
+            if (pf_use && ~(|hit)) prefetch_hit  <= prefetch_hit  + 1;
         end
     end
 
@@ -268,6 +554,8 @@ module L1C_inst (
         $display("L1CI Hit  Count = %0d", read_hit);
         $display("L1CI Miss Count = %0d", read_miss);
         $display("L1CI Hit  Rate  = %0.2f%%", L1CI_Hit__Rate);
+        $display("PREFETCH L1CI Fill Count = %0d", prefetch_fill);
+        $display("PREFETCH L1CI Hit  Count = %0d", prefetch_hit);
     end
 
 endmodule
\ No newline at end of file
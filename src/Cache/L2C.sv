@@ -0,0 +1,525 @@
+module L2C (
+    input  logic        clk_i,
+    input  logic        rst_i,
+
+    // I$ <-> L2 (line fills)
+    input  logic        icache_req_i,
+    input  logic [ 3:0] icache_len_i,
+    input  logic [31:0] icache_addr_i,
+    output logic        icache_wait_o,
+    output logic        icache_out_valid_o,
+    output logic [31:0] icache_out_o,
+
+    // D$ <-> L2 (line fills, line / word writes, uncached words)
+    input  logic        dcache_req_i,
+    input  logic [ 3:0] dcache_write_i,
+    input  logic [ 3:0] dcache_len_i,
+    input  logic [31:0] dcache_addr_i,
+    input  logic [31:0] dcache_in_i,
+    output logic        dcache_in_ready_o,
+    output logic        dcache_wait_o,
+    output logic        dcache_out_valid_o,
+    output logic [31:0] dcache_out_o,
+
+    // drop a line written behind L2 (VPU non-temporal store, cbo.inval / cbo.flush)
+    input  logic        inv_req_i,
+    input  logic [31:0] inv_addr_i,
+    output logic        inv_busy_o,
+    input  logic        inv_all_i,  // drop every line (cache invalidate CSR)
+
+    // L2 <-> master0
+    output logic        I_req_o,
+    output logic [ 3:0] I_len_o,
+    output logic [31:0] I_addr_o,
+    input  logic        I_wait_i,
+    input  logic        I_out_valid_i,
+    input  logic [31:0] I_out_i,
+
+    // L2 <-> master1
+    output logic        D_req_o,
+    output logic [ 3:0] D_write_o,
+    output logic [ 3:0] D_len_o,
+    output logic [31:0] D_addr_o,
+    output logic [31:0] D_in_o,
+    input  logic        D_in_ready_i,
+    input  logic        D_wait_i,
+    input  logic        D_out_valid_i,
+    input  logic [31:0] D_out_i
+);
+
+    // cache geometry (see def.svh), a line is an L1 line
+    parameter int WAYS       = L2_WAYS;
+    parameter int SETS       = L2_SETS;
+    parameter int LINE_BYTES = DCACHE_LINE_BYTES;
+
+    localparam int WAY_BITS    = $clog2(WAYS);
+    localparam int INDEX_BITS  = $clog2(SETS);
+    localparam int OFFSET_BITS = $clog2(LINE_BYTES);
+    localparam int TAG_BITS    = 32 - INDEX_BITS - OFFSET_BITS;
+    localparam int LINE_BITS   = LINE_BYTES * 8;
+    localparam int LINE_WORDS  = LINE_BYTES / 4;
+    localparam int WORD_BITS   = $clog2(LINE_WORDS);
+
+    localparam logic [WORD_BITS-1:0] LAST_WORD = WORD_BITS'(LINE_WORDS - 1);
+
+    // --------------------------------------------
+    //              Signal Declaration             
+    // --------------------------------------------
+    typedef enum logic {
+        SRC_INST,   // I$, master0
+        SRC_DATA    // D$, master1
+    } SRC_t;
+
+    // request port, one for each L1
+    typedef enum logic [2:0] {
+        PORT_IDLE,   // accept a request
+        PORT_LOOKUP, // wait for the tag / data array lookup
+        PORT_HIT,    // send the line from the line buffer (a beat per cycle)
+        PORT_MISS,   // the same burst to memory, the beats go through to L1
+        PORT_FILL,   // write the line into L2
+        PORT_PASS,   // uncached access / write, straight to memory
+        PORT_UPDATE  // write-through: put the written bytes into L2 if the line is there
+    } PORT_STATE_t;
+
+    typedef struct packed {
+        PORT_STATE_t            state;
+        logic [31:0]            addr;
+        logic [ 3:0]            len;
+        logic                   write;  // memory is written (no line fill)
+        logic                   noalloc; // the line was written / dropped during the miss, do not fill it
+        logic [WORD_BITS  -1:0] count;  // beats done
+        logic [LINE_BITS  -1:0] line;   // line buffer, word 0 at the top
+        logic [LINE_BYTES -1:0] strb;   // bytes written to memory
+    } PORT_t;
+
+    // tag / data array operation, read the arrays, then act on the lookup result
+    typedef enum logic [1:0] {
+        OP_READ,    // line lookup for a read
+        OP_FILL,    // write the filled line (unless the other port has filled it, or noalloc)
+        OP_WRITE,   // write the bytes written to memory if the line is there
+        OP_INV      // drop the line if it is there
+    } OP_t;
+
+    typedef struct packed {
+        logic        valid;     // act on the lookup result in this cycle
+        OP_t         op;
+        SRC_t        src;
+        logic [31:0] addr;
+    } ARR_OP_t;
+
+    typedef struct packed {
+        logic        valid;
+        logic [31:0] addr;
+    } INV_BUF_t;
+
+    PORT_t                           port_q[2], port_n[2];
+    ARR_OP_t                         arr_q, arr_n;
+    INV_BUF_t                        inv_q, inv_n;
+    SRC_t                            rr_q, rr_n;           // the port to serve first (round robin)
+    logic                            arr_free;             // no line write in the act stage
+    logic                            want[2];              // the port waits for an array operation
+    logic                            fill_req[2];          // the request is a cacheable line read
+    logic                            cached[2];            // the port accesses a cacheable address
+    logic [WORD_BITS   -1:0]         beat_word;
+
+    // L1 side / memory side of each port
+    logic                            up_req[2], up_wait[2], up_out_valid[2], up_in_ready[2];
+    logic [ 3:0]                     up_len[2], up_write[2];
+    logic [31:0]                     up_addr[2], up_in[2], up_out[2];
+    logic                            dn_req[2], dn_wait[2], dn_out_valid[2], dn_in_ready[2];
+    logic [ 3:0]                     dn_len[2], dn_write[2];
+    logic [31:0]                     dn_addr[2], dn_in[2], dn_out[2];
+
+    logic [WAYS-1:0][LINE_BYTES-1:0] DA_write;
+    logic [LINE_BITS   -1:0]         DA_in;
+    logic                            DA_read;
+    logic [WAYS-1:0][LINE_BITS -1:0] DA_out;
+
+    logic [WAYS        -1:0]         TA_write;
+    logic [TAG_BITS    -1:0]         TA_in;
+    logic                            TA_read;
+    logic [WAYS-1:0][TAG_BITS  -1:0] TA_out;
+
+    logic [INDEX_BITS  -1:0]         index, read_index;    // set of the act stage / address to tag/data array
+    logic [SETS-1:0][WAYS-1:0]       valid_q, valid_n;     // valid bit of each way of each set
+    logic [WAYS        -1:0]         hit;                  // hit way (one-hot)
+    logic [WAY_BITS    -1:0]         hit_way;
+    logic [LINE_BITS   -1:0]         hit_line;
+
+    // tree-PLRU update (a read hit, or a fill)
+    logic                            plru_touch;
+    logic [WAY_BITS    -1:0]         plru_way;
+    logic [WAY_BITS    -1:0]         victim_way;
+
+    // --------------------------------------------
+    //                 Port Mapping                
+    // --------------------------------------------
+    assign up_req  [SRC_INST] = icache_req_i;
+    assign up_len  [SRC_INST] = icache_len_i;
+    assign up_addr [SRC_INST] = icache_addr_i;
+    assign up_write[SRC_INST] = 4'd0;
+    assign up_in   [SRC_INST] = 32'd0;
+    assign up_req  [SRC_DATA] = dcache_req_i;
+    assign up_len  [SRC_DATA] = dcache_len_i;
+    assign up_addr [SRC_DATA] = dcache_addr_i;
+    assign up_write[SRC_DATA] = dcache_write_i;
+    assign up_in   [SRC_DATA] = dcache_in_i;
+
+    assign icache_wait_o      = up_wait     [SRC_INST];
+    assign icache_out_valid_o = up_out_valid[SRC_INST];
+    assign icache_out_o       = up_out      [SRC_INST];
+    assign dcache_in_ready_o  = up_in_ready [SRC_DATA];
+    assign dcache_wait_o      = up_wait     [SRC_DATA];
+    assign dcache_out_valid_o = up_out_valid[SRC_DATA];
+    assign dcache_out_o       = up_out      [SRC_DATA];
+
+    assign I_req_o                  = dn_req [SRC_INST];
+    assign I_len_o                  = dn_len [SRC_INST];
+    assign I_addr_o                 = dn_addr[SRC_INST];
+    assign dn_wait     [SRC_INST]   = I_wait_i;
+    assign dn_out_valid[SRC_INST]   = I_out_valid_i;
+    assign dn_out      [SRC_INST]   = I_out_i;
+    assign dn_in_ready [SRC_INST]   = 1'b0;
+    assign D_req_o                  = dn_req  [SRC_DATA];
+    assign D_write_o                = dn_write[SRC_DATA];
+    assign D_len_o                  = dn_len  [SRC_DATA];
+    assign D_addr_o                 = dn_addr [SRC_DATA];
+    assign D_in_o                   = dn_in   [SRC_DATA];
+    assign dn_wait     [SRC_DATA]   = D_wait_i;
+    assign dn_out_valid[SRC_DATA]   = D_out_valid_i;
+    assign dn_out      [SRC_DATA]   = D_out_i;
+    assign dn_in_ready [SRC_DATA]   = D_in_ready_i;
+
+    assign inv_busy_o = inv_q.valid;
+
+    // --------------------------------------------
+    //                L2 Controller                
+    // --------------------------------------------
+    always_ff @(posedge clk_i) begin
+        if (rst_i) begin
+            port_q[SRC_INST] <= PORT_t'(0);
+            port_q[SRC_DATA] <= PORT_t'(0);
+            arr_q            <= ARR_OP_t'(0);
+            inv_q            <= INV_BUF_t'(0);
+            rr_q             <= SRC_INST;
+            valid_q          <= (SETS*WAYS)'(0);
+        end else begin
+            port_q           <= port_n;
+            arr_q            <= arr_n;
+            inv_q            <= inv_n;
+            rr_q             <= rr_n;
+            valid_q          <= valid_n;
+        end
+    end
+
+    always_comb begin
+        index    = arr_q.addr[OFFSET_BITS +: INDEX_BITS];
+        hit      = WAYS'(0);
+        hit_way  = WAY_BITS'(0);
+        hit_line = LINE_BITS'(0);
+
+        for (int w = 0; w < WAYS; w++) begin
+            if (valid_q[index][w] && (TA_out[w] == arr_q.addr[31 -: TAG_BITS])) begin
+                hit[w]   = 1'b1;
+                hit_way  = WAY_BITS'(w);
+                hit_line = DA_out[w];
+            end
+        end
+
+        // MMIO has side effects and the VPU reads / writes the VSPM directly,
+        // so both go to memory and are never allocated
+        for (int p = 0; p < 2; p++) begin
+            fill_req[p] = ~(|up_write[p]) && (up_len[p] == 4'(LINE_WORDS - 1)) &&
+                          ~(up_addr[p][31:28] == 4'h1) && ~(up_addr[p] >= `VSPM_start_addr && up_addr[p] <= `VSPM_end_addr);
+            cached[p]   = ~(port_q[p].addr[31:28] == 4'h1) && ~(port_q[p].addr >= `VSPM_start_addr && port_q[p].addr <= `VSPM_end_addr);
+        end
+    end
+
+    always_comb begin
+        port_n     = port_q;
+        arr_n      = ARR_OP_t'(0);
+        inv_n      = inv_q;
+        rr_n       = rr_q;
+        valid_n    = valid_q;
+        beat_word  = WORD_BITS'(0);
+
+        // default TA / DA assignment
+        read_index = index;
+        TA_read    = 1'b0;
+        TA_write   = WAYS'(0);
+        TA_in      = arr_q.addr[31 -: TAG_BITS];
+        DA_read    = 1'b0;
+        DA_write   = (WAYS*LINE_BYTES)'(0);
+        DA_in      = port_q[arr_q.src].line;
+
+        // a hit is the most recently used way of the set
+        plru_touch = 1'b0;
+        plru_way   = hit_way;
+
+        // default L1 / memory assignment
+        for (int p = 0; p < 2; p++) begin
+            up_wait     [p] = (port_q[p].state != PORT_IDLE) | up_req[p];
+            up_out_valid[p] = 1'b0;
+            up_out      [p] = dn_out[p];
+            up_in_ready [p] = 1'b0;
+
+            dn_req      [p] = 1'b0;
+            dn_len      [p] = port_q[p].len;
+            dn_addr     [p] = port_q[p].addr;
+            dn_write    [p] = up_write[p];
+            dn_in       [p] = up_in[p];
+        end
+
+        // act on the lookup result (arrays read in the last cycle)
+        if (arr_q.valid) begin
+            unique case (arr_q.op)
+                OP_READ : begin
+                    port_n[arr_q.src].count = WORD_BITS'(0);
+
+                    if (|hit) begin
+                        port_n[arr_q.src].state = PORT_HIT;
+                        port_n[arr_q.src].line  = hit_line;
+                        plru_touch              = 1'b1;
+
+                    // miss --> the same burst to memory
+                    end else begin
+                        port_n[arr_q.src].state = PORT_MISS;
+                        dn_req[arr_q.src]       = 1'b1;
+                    end
+                end
+
+                OP_FILL : begin
+                    // the other port may have filled the line already
+                    if (!(|hit) && !port_q[arr_q.src].noalloc) begin
+                        TA_write[victim_way]       = 1'b1;
+                        DA_write[victim_way]       = {LINE_BYTES{1'b1}};
+                        valid_n[index][victim_way] = 1'b1;
+                        plru_touch                 = 1'b1;
+                        plru_way                   = victim_way;
+                    end
+
+                    port_n[arr_q.src].state = PORT_IDLE;
+                end
+
+                OP_WRITE : begin
+                    if (|hit) DA_write[hit_way] = port_q[arr_q.src].strb;
+
+                    port_n[arr_q.src].state = PORT_IDLE;
+                end
+
+                OP_INV : begin
+                    valid_n[index] = valid_q[index] & ~hit;
+                    inv_n.valid    = 1'b0;
+                end
+
+                default : ; // nothing to do
+            endcase
+
+            // ------------------------------------------------------------
+            // a miss burst may have read the line before the write / the
+            // line written behind L2 reached memory, so a port still
+            // filling that line must not allocate its (stale) copy
+            // ------------------------------------------------------------
+            if ((arr_q.op == OP_WRITE) || (arr_q.op == OP_INV)) begin
+                for (int p = 0; p < 2; p++) begin
+                    if (((port_q[p].state == PORT_MISS) || (port_q[p].state == PORT_FILL)) &&
+                        (port_q[p].addr[31:OFFSET_BITS] == arr_q.addr[31:OFFSET_BITS])) begin
+                        port_n[p].noalloc = 1'b1;
+                    end
+                end
+            end
+        end
+
+        for (int p = 0; p < 2; p++) begin
+            unique case (port_q[p].state)
+                PORT_IDLE : begin
+                    if (up_req[p]) begin
+                        port_n[p] = {PORT_LOOKUP, up_addr[p], up_len[p], |up_write[p], 1'b0, WORD_BITS'(0), LINE_BITS'(0), LINE_BYTES'(0)};
+
+                        // uncached / single word / write --> straight to memory
+                        if (!fill_req[p]) begin
+                            port_n[p].state = PORT_PASS;
+                            dn_req [p]      = 1'b1;
+                            dn_len [p]      = up_len[p];
+                            dn_addr[p]      = up_addr[p];
+                        end
+                    end
+                end
+
+                PORT_HIT : begin
+                    // wrap around the line from the first word, like the memory burst
+                    up_out_valid[p] = 1'b1;
+                    up_out      [p] = port_q[p].line[(LAST_WORD - WORD_BITS'(port_q[p].addr[2 +: WORD_BITS] + port_q[p].count))*32 +: 32];
+                    port_n[p].count = port_q[p].count + WORD_BITS'(1);
+
+                    if (port_q[p].count == WORD_BITS'(port_q[p].len)) begin
+                        port_n[p].state = PORT_IDLE;
+                    end
+                end
+
+                PORT_MISS : begin
+                    // the beats go to L1 right away (early restart), and into the line buffer
+                    up_out_valid[p] = dn_out_valid[p];
+
+                    if (dn_out_valid[p]) begin
+                        port_n[p].line[(LAST_WORD - WORD_BITS'(port_q[p].addr[2 +: WORD_BITS] + port_q[p].count))*32 +: 32] = dn_out[p];
+                        port_n[p].count                                                                                     = port_q[p].count + WORD_BITS'(1);
+                    end else if (!dn_wait[p]) begin
+                        port_n[p].state = PORT_FILL;
+                    end
+                end
+
+                PORT_PASS : begin
+                    up_out_valid[p] = dn_out_valid[p];
+
+                    // memory is done --> L1 is done, unless L2 has to be updated first
+                    if (!dn_out_valid[p] && !dn_wait[p]) begin
+                        if (port_q[p].write && cached[p]) begin
+                            port_n[p].state = PORT_UPDATE;
+                        end else begin
+                            port_n[p].state = PORT_IDLE;
+                            up_wait[p]      = 1'b0;
+                        end
+                    end
+                end
+
+                default : ; // wait for the array operation
+            endcase
+
+            // write beats taken by the master (the first one may go in the request cycle)
+            if ((port_n[p].state == PORT_PASS) && dn_in_ready[p]) begin
+                beat_word       = port_n[p].addr[2 +: WORD_BITS] + port_n[p].count;
+                up_in_ready[p]  = 1'b1;
+
+                port_n[p].line[(LAST_WORD - beat_word)*32 +: 32] = up_in[p];
+                port_n[p].strb[(LAST_WORD - beat_word)*4  +: 4]  = port_n[p].strb[(LAST_WORD - beat_word)*4 +: 4] | up_write[p];
+                port_n[p].count                                  = port_n[p].count + WORD_BITS'(1);
+            end
+
+            want[p] = (port_n[p].state == PORT_LOOKUP) || (port_n[p].state == PORT_FILL) || (port_n[p].state == PORT_UPDATE);
+        end
+
+        // a line written behind L2 (one at a time, D$ waits for inv_busy_o)
+        if (inv_req_i) begin
+            inv_n = {1'b1, inv_addr_i};
+        end
+
+        // L2 is write-through, memory has every line
+        if (inv_all_i) begin
+            valid_n = (SETS*WAYS)'(0);
+        end
+
+        // start the next operation when the arrays are free (invalidate > round robin of the ports)
+        arr_free = !(arr_q.valid && ((arr_q.op == OP_FILL) || (arr_q.op == OP_WRITE)));
+
+        if (arr_free) begin
+            if (inv_n.valid && !(arr_q.valid && arr_q.op == OP_INV)) begin
+                arr_n = {1'b1, OP_INV, SRC_INST, inv_n.addr};
+            end else if (want[rr_q]) begin
+                arr_n = {1'b1, ((port_n[rr_q].state == PORT_LOOKUP) ? (OP_READ) : (port_n[rr_q].state == PORT_FILL) ? (OP_FILL) : (OP_WRITE)), rr_q, port_n[rr_q].addr};
+                rr_n  = SRC_t'(~rr_q);
+            end else if (want[~rr_q]) begin
+                arr_n = {1'b1, ((port_n[~rr_q].state == PORT_LOOKUP) ? (OP_READ) : (port_n[~rr_q].state == PORT_FILL) ? (OP_FILL) : (OP_WRITE)), SRC_t'(~rr_q), port_n[~rr_q].addr};
+            end
+
+            // set up tag/data array read
+            if (arr_n.valid) begin
+                TA_read    = 1'b1;
+                DA_read    = (arr_n.op == OP_READ);
+                read_index = arr_n.addr[OFFSET_BITS +: INDEX_BITS];
+            end
+        end
+    end
+
+    data_array_wrapper #(
+        .WAYS       ( WAYS       ),
+        .SETS       ( SETS       ),
+        .LINE_BYTES ( LINE_BYTES )
+    ) DA (
+        .CK  ( clk_i      ),
+        .CS  ( 1'b1       ),
+        .OE  ( DA_read    ),
+        .A   ( read_index ),
+        .WEB ( DA_write   ),
+        .DI  ( DA_in      ),
+        .DO  ( DA_out     )
+    );
+
+    tag_array_wrapper #(
+        .WAYS       ( WAYS       ),
+        .SETS       ( SETS       ),
+        .TAG_BITS   ( TAG_BITS   )
+    ) TA (
+        .CK  ( clk_i      ),
+        .CS  ( 1'b1       ),
+        .OE  ( TA_read    ),
+        .A   ( read_index ),
+        .DI  ( TA_in      ),
+        .WEB ( TA_write   ),
+        .DO  ( TA_out     )
+    );
+
+    cache_plru #(
+        .WAYS         ( WAYS       ),
+        .SETS         ( SETS       )
+    ) PLRU (
+        .clk_i        ( clk_i      ),
+        .rst_i        ( rst_i      ),
+        .touch_i      ( plru_touch ),
+        .touch_set_i  ( index      ),
+        .touch_way_i  ( plru_way   ),
+        .victim_set_i ( index      ),
+        .victim_way_o ( victim_way )
+    );
+
+    // --------------------------------------------
+    //              Performance Counts             
+    // --------------------------------------------
+    integer inst_hit, inst_miss;
+    integer data_hit, data_miss;
+    integer write_update, uncached;
+
+    always_ff @(posedge clk_i) begin
+        if (rst_i) begin
+            inst_hit     <= 0;
+            inst_miss    <= 0;
+            data_hit     <= 0;
+            data_miss    <= 0;
+            write_update <= 0;
+            uncached     <= 0;
+        end else begin
+            if (arr_q.valid && arr_q.op == OP_READ) begin
+                if (arr_q.src == SRC_INST) begin
+                    if (|hit) inst_hit  <= inst_hit  + 1;
+                    else      inst_miss <= inst_miss + 1;
+                end else begin
+                    if (|hit) data_hit  <= data_hit  + 1;
+                    else      data_miss <= data_miss + 1;
+                end
+            end
+
+            if (arr_q.valid && arr_q.op == OP_WRITE && (|hit)) write_update <= write_update + 1;
+
+            if (port_q[SRC_DATA].state == PORT_IDLE && up_req[SRC_DATA] && !fill_req[SRC_DATA] && !(|up_write[SRC_DATA])) uncached <= uncached + 1;
+        end
+    end
+
+    final begin
+        real L2C_Hit__Rate;
+        if (inst_hit + inst_miss + data_hit + data_miss > 33'd0) begin // avoid divide 0
+            L2C_Hit__Rate = ((inst_hit + data_hit) * 100.0) / (inst_hit + inst_miss + data_hit + data_miss);
+        end
+        else begin
+            L2C_Hit__Rate = 0.0;
+        end
+        $display("L2C:");
+        $display("INST L2C Hit  Count = %0d", inst_hit);
+        $display("INST L2C Miss Count = %0d", inst_miss);
+        $display("DATA L2C Hit  Count = %0d", data_hit);
+        $display("DATA L2C Miss Count = %0d", data_miss);
+        $display("L2C Hit  Rate  = %0.2f%%", L2C_Hit__Rate);
+        $display("WRITE L2C Update Count = %0d", write_update);
+        $display("UNCACHED L2C Read Count = %0d", uncached);
+    end
+
+endmodule
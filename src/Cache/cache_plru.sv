@@ -0,0 +1,68 @@
+// --------------------------------------------
+// Tree pseudo-LRU replacement, one tree per set
+// * WAYS-1 node bits, node n has children 2n+1 / 2n+2
+// * a node points to its less recently used half (0: left)
+// * a used way turns the nodes on its path away from it
+// --------------------------------------------
+module cache_plru #(
+    parameter int WAYS = 2,   // power of two, at least 2
+    parameter int SETS = 32
+) (
+    input  logic                    clk_i,
+    input  logic                    rst_i,
+
+    // a way of the set is used (hit / fill)
+    input  logic                    touch_i,
+    input  logic [$clog2(SETS)-1:0] touch_set_i,
+    input  logic [$clog2(WAYS)-1:0] touch_way_i,
+
+    // the next way to replace in the set
+    input  logic [$clog2(SETS)-1:0] victim_set_i,
+    output logic [$clog2(WAYS)-1:0] victim_way_o
+);
+
+    localparam int WAY_BITS = $clog2(WAYS);
+
+    // --------------------------------------------
+    //              Signal Declaration             
+    // --------------------------------------------
+    logic [WAYS-2:0] tree_q[SETS], tree_n[SETS];
+    int              victim_node, touch_node;
+
+    // --------------------------------------------
+    //                 PLRU Trees                  
+    // --------------------------------------------
+    // walk from the root to the least recently used way
+    always_comb begin
+        victim_way_o = WAY_BITS'(0);
+        victim_node  = 0;
+
+        for (int l = 0; l < WAY_BITS; l++) begin
+            victim_way_o[WAY_BITS-1-l] = tree_q[victim_set_i][victim_node];
+            victim_node                = 2*victim_node + 1 + int'(tree_q[victim_set_i][victim_node]);
+        end
+    end
+
+    always_comb begin
+        tree_n     = tree_q;
+        touch_node = 0;
+
+        if (touch_i) begin
+            for (int l = 0; l < WAY_BITS; l++) begin
+                tree_n[touch_set_i][touch_node] = ~touch_way_i[WAY_BITS-1-l];
+                touch_node                      = 2*touch_node + 1 + int'(touch_way_i[WAY_BITS-1-l]);
+            end
+        end
+    end
+
+    always_ff @(posedge clk_i) begin
+        if (rst_i) begin
+            foreach (tree_q[i]) begin
+                tree_q[i] <= (WAYS-1)'(0);
+            end
+        end else begin
+            tree_q <= tree_n;
+        end
+    end
+
+endmodule
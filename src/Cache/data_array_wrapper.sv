@@ -1,98 +1,72 @@
-module data_array_wrapper (
-    input          CK,
-    input          CS,
-    input          OE,
-    input  [4:0]   A,
-    input  [ 15:0] WEB1,
-    input  [ 15:0] WEB2,
-    input  [127:0] DI,
-    output [127:0] DO1,
-    output [127:0] DO2
+// --------------------------------------------
+// Data array of all ways, built from 32 x 64 SRAM macros
+// * a line is LINE_BYTES/8 macros side by side (word 0 at the top)
+// * SETS/32 macros are stacked for the sets of a way
+// * WEB is the byte write enable of each way (active high)
+// --------------------------------------------
+module data_array_wrapper #(
+    parameter int WAYS       = 2,
+    parameter int SETS       = 32,   // multiple of 32
+    parameter int LINE_BYTES = 16    // multiple of 8
+) (
+    input                                CK,
+    input                                CS,
+    input                                OE,
+    input  [$clog2(SETS)-1:0]            A,
+    input  [WAYS-1:0][LINE_BYTES  -1:0]  WEB,
+    input  [LINE_BYTES*8-1:0]            DI,
+    output [WAYS-1:0][LINE_BYTES*8-1:0]  DO
 );
 
-    logic        CEB1, CEB2, CEB3, CEB4;
-    logic [63:0] Q1, Q2, Q3, Q4;
-    logic [63:0] BWEB1, BWEB2, BWEB3, BWEB4;
+    localparam int ROWS      = 32;              // rows of one macro
+    localparam int BANKS     = SETS / ROWS;     // macros stacked in a way
+    localparam int COLS      = LINE_BYTES / 8;  // macros side by side in a line
+    localparam int BANK_BITS = (BANKS > 1) ? $clog2(BANKS) : 1;
 
-    assign CEB1 = ~(CS & (OE | (|WEB1[15:8]) ));
-    assign CEB2 = ~(CS & (OE | (|WEB1[ 7:0]) ));
-    assign CEB3 = ~(CS & (OE | (|WEB2[15:8]) ));
-    assign CEB4 = ~(CS & (OE | (|WEB2[ 7:0]) ));
+    logic [BANK_BITS-1:0] bank, bank_q; // the bank being accessed / read in the last cycle
+    logic [63:0]          Q[WAYS][BANKS][COLS];
 
-    assign BWEB1 = {{8{WEB1[15]}}, {8{WEB1[14]}}, {8{WEB1[13]}}, {8{WEB1[12]}},
-                    {8{WEB1[11]}}, {8{WEB1[10]}}, {8{WEB1[ 9]}}, {8{WEB1[ 8]}}};
-    assign BWEB2 = {{8{WEB1[ 7]}}, {8{WEB1[ 6]}}, {8{WEB1[ 5]}}, {8{WEB1[ 4]}},
-                    {8{WEB1[ 3]}}, {8{WEB1[ 2]}}, {8{WEB1[ 1]}}, {8{WEB1[ 0]}}};
-    assign BWEB3 = {{8{WEB2[15]}}, {8{WEB2[14]}}, {8{WEB2[13]}}, {8{WEB2[12]}},
-                    {8{WEB2[11]}}, {8{WEB2[10]}}, {8{WEB2[ 9]}}, {8{WEB2[ 8]}}};
-    assign BWEB4 = {{8{WEB2[ 7]}}, {8{WEB2[ 6]}}, {8{WEB2[ 5]}}, {8{WEB2[ 4]}},
-                    {8{WEB2[ 3]}}, {8{WEB2[ 2]}}, {8{WEB2[ 1]}}, {8{WEB2[ 0]}}};
+    assign bank = BANK_BITS'(A >> $clog2(ROWS));
 
-    assign DO1 = {Q1, Q2};
-    assign DO2 = {Q3, Q4};
+    // Q keeps the last read value, so only follow the bank of a read
+    always_ff @(posedge CK) begin
+        if (CS & OE) bank_q <= bank;
+    end
 
-    TS1N16ADFPCLLLVTA128X64M4SWSHOD_data_array i_data_array1_1 (
-        .CLK        ( CK           ),
-        .A          ( A            ),
-        .CEB        ( CEB1         ),  // chip enable, active LOW
-        .WEB        ( ~|WEB1[15:8] ),  // write:LOW, read:HIGH
-        .BWEB       ( ~BWEB1       ),  // bitwise write enable write:LOW
-        .D          ( DI[127:64]   ),  // Data into RAM
-        .Q          ( Q1           ),  // Data out of RAM
-        .RTSEL      (              ),
-        .WTSEL      (              ),
-        .SLP        (              ),
-        .DSLP       (              ),
-        .SD         (              ),
-        .PUDELAY    (              )
-    );
+    generate
+        for (genvar w = 0; w < WAYS; w++) begin : WAY
+            for (genvar c = 0; c < COLS; c++) begin : COL
+                logic [ 7:0] web;
+                logic [63:0] bweb;
 
-    TS1N16ADFPCLLLVTA128X64M4SWSHOD_data_array i_data_array1_2 (
-        .CLK        ( CK           ),
-        .A          ( A            ),
-        .CEB        ( CEB2         ),  // chip enable, active LOW
-        .WEB        ( ~|WEB1[ 7:0] ),  // write:LOW, read:HIGH
-        .BWEB       ( ~BWEB2       ),  // bitwise write enable write:LOW
-        .D          ( DI[63:0]     ),  // Data into RAM
-        .Q          ( Q2           ),  // Data out of RAM
-        .RTSEL      (              ),
-        .WTSEL      (              ),
-        .SLP        (              ),
-        .DSLP       (              ),
-        .SD         (              ),
-        .PUDELAY    (              )
-    );
+                assign web = WEB[w][LINE_BYTES-1-c*8 -: 8];
+                assign DO[w][LINE_BYTES*8-1-c*64 -: 64] = Q[w][bank_q][c];
 
-    TS1N16ADFPCLLLVTA128X64M4SWSHOD_data_array i_data_array2_1 (
-        .CLK        ( CK           ),
-        .A          ( A            ),
-        .CEB        ( CEB3         ),  // chip enable, active LOW
-        .WEB        ( ~|WEB2[15:8] ),  // write:LOW, read:HIGH
-        .BWEB       ( ~BWEB3       ),  // bitwise write enable write:LOW
-        .D          ( DI[127:64]   ),  // Data into RAM
-        .Q          ( Q3           ),  // Data out of RAM
-        .RTSEL      (              ),
-        .WTSEL      (              ),
-        .SLP        (              ),
-        .DSLP       (              ),
-        .SD         (              ),
-        .PUDELAY    (              )
-    );
+                always_comb begin
+                    for (int i = 0; i < 8; i++) begin
+                        bweb[i*8 +: 8] = {8{web[i]}};
+                    end
+                end
 
-    TS1N16ADFPCLLLVTA128X64M4SWSHOD_data_array i_data_array2_2 (
-        .CLK        ( CK           ),
-        .A          ( A            ),
-        .CEB        ( CEB4         ),  // chip enable, active LOW
-        .WEB        ( ~|WEB2[ 7:0] ),  // write:LOW, read:HIGH
-        .BWEB       ( ~BWEB4       ),  // bitwise write enable write:LOW
-        .D          ( DI[63:0]     ),  // Data into RAM
-        .Q          ( Q4           ),  // Data out of RAM
-        .RTSEL      (              ),
-        .WTSEL      (              ),
-        .SLP        (              ),
-        .DSLP       (              ),
-        .SD         (              ),
-        .PUDELAY    (              )
-    );
+                for (genvar b = 0; b < BANKS; b++) begin : BANK
+                    TS1N16ADFPCLLLVTA128X64M4SWSHOD_data_array i_data_array (
+                        .CLK        ( CK                                             ),
+                        .A          ( A[4:0]                                         ),
+                        .CEB        ( ~(CS & (bank == BANK_BITS'(b)) & (OE | (|web))) ),  // chip enable, active LOW
+                        .WEB        ( ~|web                                          ),  // write:LOW, read:HIGH
+                        .BWEB       ( ~bweb                                          ),  // bitwise write enable write:LOW
+                        .D          ( DI[LINE_BYTES*8-1-c*64 -: 64]                  ),  // Data into RAM
+                        .Q          ( Q[w][b][c]                                     ),  // Data out of RAM
+                        .RTSEL      (                                                ),
+                        .WTSEL      (                                                ),
+                        .SLP        (                                                ),
+                        .DSLP       (                                                ),
+                        .SD         (                                                ),
+                        .PUDELAY    (                                                )
+                    );
+                end
+            end
+        end
+    endgenerate
 
-endmodule
\ No newline at end of file
+endmodule
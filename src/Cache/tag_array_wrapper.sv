@@ -1,54 +1,60 @@
-module tag_array_wrapper (
-    input         CK,
-    input         CS,
-    input         OE,
-    input  [4:0]  A,
-    input  [22:0] DI,
-    input         WEB1,
-    input         WEB2,
-    output [22:0] DO1,
-    output [22:0] DO2
+// --------------------------------------------
+// Tag array of all ways, built from 32 x 32 SRAM macros
+// * SETS/32 macros are stacked for the sets of a way
+// * WEB is the write enable of each way (active high)
+// --------------------------------------------
+module tag_array_wrapper #(
+    parameter int WAYS     = 2,
+    parameter int SETS     = 32,  // multiple of 32
+    parameter int TAG_BITS = 23   // up to 32
+) (
+    input                             CK,
+    input                             CS,
+    input                             OE,
+    input  [$clog2(SETS)-1:0]         A,
+    input  [TAG_BITS-1:0]             DI,
+    input  [WAYS-1:0]                 WEB,
+    output [WAYS-1:0][TAG_BITS-1:0]   DO
 );
 
-    logic        CEB1, CEB2;
-    logic [31:0] Q1, Q2, D;
+    localparam int ROWS      = 32;          // rows of one macro
+    localparam int BANKS     = SETS / ROWS; // macros stacked in a way
+    localparam int BANK_BITS = (BANKS > 1) ? $clog2(BANKS) : 1;
 
-    assign CEB1 = ~(CS & (OE | WEB1));
-    assign CEB2 = ~(CS & (OE | WEB2));
-    assign D    = {9'd0, DI};
-    assign DO1  = Q1[22:0];
-    assign DO2  = Q2[22:0];
+    logic [BANK_BITS-1:0] bank, bank_q; // the bank being accessed / read in the last cycle
+    logic [31:0]          D;
+    logic [31:0]          Q[WAYS][BANKS];
 
-    TS1N16ADFPCLLLVTA128X64M4SWSHOD_tag_array i_tag_array1 (
-        .CLK        ( CK    ),
-        .A          ( A     ),
-        .CEB        ( CEB1  ),  // chip enable, active LOW
-        .WEB        ( ~WEB1 ),  // write:LOW, read:HIGH
-        .BWEB       ( 32'd0 ),  // bitwise write enable write:LOW
-        .D          ( D     ),  // Data into RAM
-        .Q          ( Q1    ),  // Data out of RAM
-        .RTSEL      (       ),
-        .WTSEL      (       ),
-        .SLP        (       ),
-        .DSLP       (       ),
-        .SD         (       ),
-        .PUDELAY    (       )
-    );
+    assign bank = BANK_BITS'(A >> $clog2(ROWS));
+    assign D    = 32'(DI);
 
-    TS1N16ADFPCLLLVTA128X64M4SWSHOD_tag_array i_tag_array2 (
-        .CLK        ( CK    ),
-        .A          ( A     ),
-        .CEB        ( CEB2  ),  // chip enable, active LOW
-        .WEB        ( ~WEB2 ),  // write:LOW, read:HIGH
-        .BWEB       ( 32'd0 ),  // bitwise write enable write:LOW
-        .D          ( D     ),  // Data into RAM
-        .Q          ( Q2    ),  // Data out of RAM
-        .RTSEL      (       ),
-        .WTSEL      (       ),
-        .SLP        (       ),
-        .DSLP       (       ),
-        .SD         (       ),
-        .PUDELAY    (       )
-    );
+    // Q keeps the last read value, so only follow the bank of a read
+    always_ff @(posedge CK) begin
+        if (CS & OE) bank_q <= bank;
+    end
 
-endmodule
\ No newline at end of file
+    generate
+        for (genvar w = 0; w < WAYS; w++) begin : WAY
+            assign DO[w] = Q[w][bank_q][TAG_BITS-1:0];
+
+            for (genvar b = 0; b < BANKS; b++) begin : BANK
+                TS1N16ADFPCLLLVTA128X64M4SWSHOD_tag_array i_tag_array (
+                    .CLK        ( CK                                           ),
+                    .A          ( A[4:0]                                       ),
+                    .CEB        ( ~(CS & (bank == BANK_BITS'(b)) & (OE | WEB[w])) ),  // chip enable, active LOW
+                    .WEB        ( ~WEB[w]                                      ),  // write:LOW, read:HIGH
+                    .BWEB       ( 32'd0                                        ),  // bitwise write enable write:LOW
+                    .D          ( D                                            ),  // Data into RAM
+                    .Q          ( Q[w][b]                                      ),  // Data out of RAM
+                    .RTSEL      (                                              ),
+                    .WTSEL      (                                              ),
+                    .SLP        (                                              ),
+                    .DSLP       (                                              ),
+                    .SD         (                                              ),
+                    .PUDELAY    (                                              )
+                );
+            end
+        end
+    endgenerate
+
+endmodule
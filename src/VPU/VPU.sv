@@ -1,7 +1,7 @@
 // --------------------------------------------
 //             Support instruction             
 // --------------------------------------------
-// * IMPORTANT : we not yet support widening or narrowing instruction
+// * IMPORTANT : we not yet support widening instruction, narrowing is only used by vnclip[u]
 // Total Support Instructions : 
 //
 // --------------------------------------------
@@ -109,8 +109,8 @@
 //    * vssrl     (VV, VI, VX) --> support
 //    * vssra     (VV, VI, VX) --> support
 // 19. Vector Narrowing Fixed-Point Clip Instructions
-//    * vnclipu   (VV, VI, VX) --> not support
-//    * vnclip    (VV, VI, VX) --> not support
+//    * vnclipu   (VV, VI, VX) --> support
+//    * vnclip    (VV, VI, VX) --> support
 //
 // --------------------------------------------
 //        Vector Reduction Instructions        
@@ -151,8 +151,8 @@
 //
 // 24. VWXUNARY0
 //    * vmv.x.s   (VV)         --> not support
-//    * vpopc     (VV)         --> not support
-//    * vfirst    (VV)         --> not support
+//    * vpopc     (VV)         --> support
+//    * vfirst    (VV)         --> support
 //
 // --------------------------------------------
 //       Vector Permutation Instructions       
@@ -183,6 +183,7 @@
 //    * vlse                   --> not support
 //    * vse                    --> support
 //    * vsse                   --> support
+//    * vle (lumop = 5'b00001) --> support (custom prefetch hint, no vd write)
 
 // --------------------------------------------
 //       RISC-V Zve64x Vector Coprocessor      
@@ -199,6 +200,7 @@ module VPU (
     output logic        vector_ack_o,
     output logic        vector_writeback_o,
     output logic        vector_pend_lsu_o,
+    input  logic        vector_trap_i,
 
     // to CPU
     output logic        vector_lsu_valid_o,
@@ -210,10 +212,36 @@ module VPU (
     output logic [ 3:0] dcache_vpu_write_o,
     output logic [31:0] dcache_vpu_addr_o,
     output logic [31:0] dcache_vpu_in_o,
+    output logic        dcache_vpu_inv_o,
+
+    // prefetch hint to D$
+    output logic        dcache_pf_request_o,
+    output logic [31:0] dcache_pf_addr_o,
+    output logic [31:0] dcache_pf_end_o,
 
     // response from D$
     input  logic        dcache_vpu_wait_i,
-    input  logic [31:0] dcache_vpu_out_i
+    input  logic [31:0] dcache_vpu_out_i,
+    input  logic        dcache_sb_empty_i,
+
+    // non-temporal burst (bypass D$)
+    output logic        nt_request_o,
+    output logic        nt_write_o,
+    output logic [31:0] nt_addr_o,
+    output logic [ 3:0] nt_len_o,
+    output logic [31:0] nt_in_o,
+    output logic [ 3:0] nt_strb_o,
+    input  logic        nt_in_ready_i,
+    input  logic        nt_wait_i,
+    input  logic        nt_out_valid_i,
+    input  logic [31:0] nt_out_i,
+
+    // vector scratchpad (bypass D$ and AXI)
+    output logic        spm_request_o,
+    output logic [ 7:0] spm_write_o,
+    output logic [31:0] spm_addr_o,
+    output logic [63:0] spm_in_o,
+    input  logic [63:0] spm_out_i
 );
 
     // --------------------------------------------
@@ -235,19 +263,43 @@ module VPU (
     logic                   dispatch_valid;
     VPU_uOP_t               dispatch_entry;
     logic                   dispatch_ready;
-
-    // to COMMIT
-    logic                   lsu_commit;
+    logic                   exe_idle;
+    logic                   vxsat_set;
+
+    // execute stage / regfile clock gate
+    logic                   viq_empty;
+    logic                   exe_clk_en;
+    logic                   exe_clk;
+
+    // performance events
+    VHPM_EVENT_t            hpm_event;
+    VPU_FU_t                hpm_exe_fu;
+    logic [VL_BITS-1:0]     hpm_elements;
+    logic                   viq_stall;
+
+    // to COMMIT (vector reorder buffer)
+    logic                   rob_alloc_lsu;
+    logic                   exe_done;
+    logic [VL_BITS-1:0]     exe_progress;
+    logic                   rob_retire;
+    logic                   rob_trap;
+    logic                   rob_squash;
+    logic                   rob_kill_pending;
+    logic                   exe_kill;
+    logic                   rob_empty;
+    logic [VL_BITS-1:0]     rob_vstart;
+    logic                   xreg_result_valid;
+    logic [31:0]            xreg_result;
 
     // EXE reg read / write
     logic [2:0][4:0]        vreg_read_addr;
-    logic [2:0][VLEN-1:0]   vreg_read_data;
+    logic [2:0][VGRP_LEN-1:0] vreg_read_data;
     logic [VLEN-1:0]        vreg_v0;
 
     logic                   vreg_write_en;
     logic [4:0]             vreg_write_addr;
-    logic [VLEN/8-1:0]      vreg_write_bweb;
-    logic [VLEN-1:0]        vreg_write_data;
+    logic [VGRP_LEN/8-1:0]  vreg_write_bweb;
+    logic [VGRP_LEN-1:0]    vreg_write_data;
 
     // Vector CSRs
     logic [VL_BITS-2:0]     vstart;
@@ -255,6 +307,7 @@ module VPU (
     logic                   vxsat;
     VTYPE_CSR_t             vtype;
     logic [VL_BITS-1:0]     vl;
+    logic                   vrelax;
 
     // --------------------------------------------
     //                  VPU Stages                 
@@ -270,11 +323,17 @@ module VPU (
         .vector_ack_o,
         .vector_writeback_o,
         .vector_pend_lsu_o,
+        .vector_trap_i,
 
         .vsew_i                 ( vtype.vsew           ),
         .vlmul_i                ( vtype.vlmul          ),
         .vxrm_i                 ( vxrm                 ),
         .vl_i                   ( vl                   ),
+        .vrelax_i               ( vrelax               ),
+        .vstart_i               ( vstart               ),
+
+        .kill_pending_i         ( rob_kill_pending     ),
+        .rob_squash_o           ( rob_squash           ),
 
         .decode_entry_valid_o   ( decode_entry_valid   ),
         .decode_entry_o         ( decode_entry         ),
@@ -295,7 +354,10 @@ module VPU (
 
         .dispatch_valid_o       ( dispatch_valid       ),
         .dispatch_entry_o       ( dispatch_entry       ),
-        .dispatch_ready_i       ( dispatch_ready       )
+        .dispatch_ready_i       ( dispatch_ready       ),
+        .exe_idle_i             ( exe_idle             ),
+        .viq_empty_o            ( viq_empty            ),
+        .viq_stall_o            ( viq_stall            )
     );
 
     // --------------------------------------------
@@ -308,6 +370,16 @@ module VPU (
         // from VPU ISSUE
         .VCFG_valid_i           ( VCFG_valid           ),
         .VCFG_entry_i           ( VCFG_entry           ),
+        .vxsat_set_i            ( vxsat_set            ),
+        .hpm_event_i            ( hpm_event            ),
+
+        // from ISSUE
+        .vstart_take_i          ( decode_ack           ),
+
+        // from COMMIT
+        .rob_trap_i             ( rob_trap             ),
+        .rob_empty_i            ( rob_empty            ),
+        .rob_vstart_i           ( rob_vstart           ),
 
         // csr value
         .vstart_o               ( vstart               ),
@@ -315,19 +387,35 @@ module VPU (
         .vxrm_o                 ( vxrm                 ),
         .vtype_o                ( vtype                ),
         .vl_o                   ( vl                   ),
+        .vrelax_o               ( vrelax               ),
 
         .VCFG_read_valid_o      ( VCFG_read_valid      ),
         .VCFG_read_data_o       ( VCFG_read_data       )
     );
 
-    VPU_execute_stage i_VPU_execute_stage (
+    // ----------------------------------------------------------
+    // execute stage and vector registers only toggle when there
+    // is work (VIQ not empty or execute stage busy); reset keeps
+    // the clock running so the synchronous reset still applies
+    // ----------------------------------------------------------
+    assign exe_clk_en = rst_i || ~viq_empty || ~exe_idle;
+
+    VPU_clock_gate i_VPU_clock_gate (
         .clk_i,
+        .en_i                   ( exe_clk_en           ),
+        .gclk_o                 ( exe_clk              )
+    );
+
+    VPU_execute_stage i_VPU_execute_stage (
+        .clk_i                  ( exe_clk              ),
         .rst_i,
 
         // from ISSUE
         .dispatch_valid_i       ( dispatch_valid       ),
         .dispatch_entry_i       ( dispatch_entry       ),
         .dispatch_ready_o       ( dispatch_ready       ),
+        .exe_idle_o             ( exe_idle             ),
+        .exe_kill_i             ( exe_kill             ),
 
         // to VPU regfile
         .vreg_read_addr_o       ( vreg_read_addr       ),
@@ -344,21 +432,64 @@ module VPU (
         .dcache_vpu_write_o,
         .dcache_vpu_addr_o,
         .dcache_vpu_in_o,
+        .dcache_vpu_inv_o,
+
+        // prefetch hint to D$
+        .dcache_pf_request_o,
+        .dcache_pf_addr_o,
+        .dcache_pf_end_o,
 
         // response from D$
         .dcache_vpu_wait_i,
         .dcache_vpu_out_i,
-
-        .lsu_commit_o           ( lsu_commit           )
+        .dcache_sb_empty_i,
+
+        // non-temporal burst
+        .nt_request_o,
+        .nt_write_o,
+        .nt_addr_o,
+        .nt_len_o,
+        .nt_in_o,
+        .nt_strb_o,
+        .nt_in_ready_i,
+        .nt_wait_i,
+        .nt_out_valid_i,
+        .nt_out_i,
+
+        // vector scratchpad
+        .spm_request_o,
+        .spm_write_o,
+        .spm_addr_o,
+        .spm_in_o,
+        .spm_out_i,
+
+        .exe_done_o             ( exe_done             ),
+        .exe_progress_o         ( exe_progress         ),
+        .xreg_result_valid_o    ( xreg_result_valid    ),
+        .xreg_result_o          ( xreg_result          ),
+        .vxsat_set_o            ( vxsat_set            ),
+        .hpm_exe_fu_o           ( hpm_exe_fu           ),
+        .hpm_elements_o         ( hpm_elements         )
     );
 
+    // --------------------------------------------
+    //             Performance Events              
+    // --------------------------------------------
+    always_comb begin
+        hpm_event.exe_fu      = hpm_exe_fu;
+        hpm_event.viq_full    = viq_stall;
+        hpm_event.unaccept    = vector_inst_valid_i && ~vector_ack_o;
+        hpm_event.dcache_wait = (hpm_exe_fu == VLSU) && dcache_vpu_wait_i;
+        hpm_event.elements    = hpm_elements;
+    end
+
 
     // --------------------------------------------
     //              VPU regisetr file              
     // --------------------------------------------
 
     VPU_regfile i_VPU_regfile (
-        .clk_i,
+        .clk_i                  ( exe_clk              ),
         .rst_i,
 
         // read port (3 ports, and 1 v0 read port)
@@ -403,6 +534,9 @@ module VPU (
     // --------------------------------------------
     //          VPU Commit stage (to CPU)          
     // --------------------------------------------
+    // CPU does not wait for a prefetch hint or a relaxed load / store
+    assign rob_alloc_lsu = (decode_entry.fu == VLSU) && ~decode_entry.mode.lsu.prefetch && ~vrelax;
+
     VPU_commit_stage i_VPU_commit_stage (
         .clk_i,
         .rst_i,
@@ -410,11 +544,120 @@ module VPU (
         .VCFG_read_valid_i      ( VCFG_read_valid      ),
         .VCFG_read_data_i       ( VCFG_read_data       ),
         .VCFG_commit_o          ( VCFG_commit          ),
-        .lsu_commit_i           ( lsu_commit           ),
+
+        .rob_alloc_i            ( decode_ack           ),
+        .rob_alloc_lsu_i        ( rob_alloc_lsu        ),
+        .rob_squash_i           ( rob_squash           ),
+
+        .exe_busy_i             ( ~exe_idle            ),
+        .exe_done_i             ( exe_done             ),
+        .exe_progress_i         ( exe_progress         ),
+        .xreg_result_valid_i    ( xreg_result_valid    ),
+        .xreg_result_i          ( xreg_result          ),
+
+        .exe_kill_o             ( exe_kill             ),
+        .rob_kill_pending_o     ( rob_kill_pending     ),
+
+        .rob_retire_o           ( rob_retire           ),
+        .rob_trap_o             ( rob_trap             ),
+        .rob_vstart_o           ( rob_vstart           ),
+        .rob_empty_o            ( rob_empty            ),
 
         .vector_lsu_valid_o,
         .vector_result_valid_o,
         .vector_result_o
     );
 
+`ifdef VPU_TRACE
+    // --------------------------------------------
+    //       Pipeline Trace (simulation only)      
+    // --------------------------------------------
+    // Kanata 0004 log for the Konata pipeline viewer, stages:
+    //   Dc   : decode buffer          Cf : VCFG (bypass VIQ)
+    //   Iq   : VIQ                    Ds : dispatch
+    //   <FU> : execute unit           Cm : done, wait to retire
+    // output file : +vpu_trace=<file> (default vpu_trace.log)
+    int          trace_fd;
+    string       trace_file;
+    int unsigned trace_uid, trace_rid;
+    int unsigned trace_dec_q[$], trace_viq_q[$], trace_rob_q[$];
+    int unsigned trace_exe_id, trace_cfg_id, trace_id;
+    string       trace_exe_fu;
+    logic        trace_exe_start, trace_cfg_retire;
+
+    initial begin
+        if (!$value$plusargs("vpu_trace=%s", trace_file)) trace_file = "vpu_trace.log";
+        trace_fd = $fopen(trace_file, "w");
+        $fwrite(trace_fd, "Kanata\t0004\nC=\t0\n");
+    end
+
+    always @(posedge clk_i) begin
+        if (rst_i) begin
+            trace_dec_q.delete();
+            trace_viq_q.delete();
+            trace_rob_q.delete();
+            trace_exe_start  = 1'b0;
+            trace_cfg_retire = 1'b0;
+        end else begin
+            $fwrite(trace_fd, "C\t1\n");
+
+            // events are written from the back of the pipeline, so a uOP
+            // that moves through several stages in one cycle stays ordered
+            if (trace_cfg_retire) begin
+                $fwrite(trace_fd, "E\t%0d\t0\tCf\nR\t%0d\t%0d\t0\n", trace_cfg_id, trace_cfg_id, trace_rid++);
+                trace_cfg_retire = 1'b0;
+            end
+
+            if (trace_exe_start) begin
+                $fwrite(trace_fd, "E\t%0d\t0\tDs\nS\t%0d\t0\t%s\n", trace_exe_id, trace_exe_id, trace_exe_fu);
+                trace_exe_start = 1'b0;
+            end
+
+            if (exe_done) begin
+                $fwrite(trace_fd, "E\t%0d\t0\t%s\nS\t%0d\t0\tCm\n", trace_exe_id, trace_exe_fu, trace_exe_id);
+            end
+
+            if (rob_retire && trace_rob_q.size() != 0) begin
+                trace_id = trace_rob_q.pop_front();
+                $fwrite(trace_fd, "E\t%0d\t0\tCm\nR\t%0d\t%0d\t0\n", trace_id, trace_id, trace_rid++);
+            end
+
+            if (dispatch_valid && trace_viq_q.size() != 0) begin
+                trace_exe_id    = trace_viq_q.pop_front();
+                trace_exe_fu    = dispatch_entry.fu.name();
+                trace_exe_start = 1'b1;
+                $fwrite(trace_fd, "E\t%0d\t0\tIq\nS\t%0d\t0\tDs\n", trace_exe_id, trace_exe_id);
+            end
+
+            if (decode_ack && trace_dec_q.size() != 0) begin
+                trace_id = trace_dec_q.pop_front();
+                trace_viq_q.push_back(trace_id);
+                trace_rob_q.push_back(trace_id);
+                $fwrite(trace_fd, "E\t%0d\t0\tDc\nS\t%0d\t0\tIq\n", trace_id, trace_id);
+            end else if (vector_trap_i && ~rob_squash && trace_dec_q.size() != 0) begin
+                // squashed in the decode buffer, the CPU restarts it
+                trace_id = trace_dec_q.pop_front();
+                $fwrite(trace_fd, "E\t%0d\t0\tDc\nR\t%0d\t%0d\t1\n", trace_id, trace_id, trace_rid);
+            end else if (VCFG_commit && trace_dec_q.size() != 0) begin
+                trace_cfg_id     = trace_dec_q.pop_front();
+                trace_cfg_retire = 1'b1;
+                $fwrite(trace_fd, "E\t%0d\t0\tDc\nS\t%0d\t0\tCf\n", trace_cfg_id, trace_cfg_id);
+            end
+
+            // a new instruction enters the decode buffer
+            if (vector_ack_o) begin
+                trace_dec_q.push_back(trace_uid);
+                $fwrite(trace_fd, "I\t%0d\t%0d\t0\n", trace_uid, trace_uid);
+                $fwrite(trace_fd, "L\t%0d\t0\t%08h %s\n", trace_uid, vector_inst_i, i_VPU_id_stage.decode_instr.fu.name());
+                $fwrite(trace_fd, "L\t%0d\t1\tvl=%0d vsew=%s vlmul=%s\n", trace_uid, vl, vtype.vsew.name(), vtype.vlmul.name());
+                $fwrite(trace_fd, "S\t%0d\t0\tDc\n", trace_uid++);
+            end
+        end
+    end
+
+    final begin
+        $fclose(trace_fd);
+    end
+`endif
+
 endmodule
\ No newline at end of file
@@ -13,7 +13,10 @@ module VPU_alu (
     // alu result
     output logic        result_valid_o,
     output logic        result_en_o,
-    output logic [63:0] result_o
+    output logic [63:0] result_o,
+
+    // request to fixed-point stage
+    output VFIXP_REQ_t  fixp_o
 );
 
     // --------------------------------------------
@@ -32,12 +35,9 @@ module VPU_alu (
     logic [64:0]  sum65, sub65;
     logic         equal, less;
 
-    logic [ 7:0]  r_add_8 , r_sub_8;
-    logic [15:0]  r_add_16, r_sub_16;
-    logic [31:0]  r_add_32, r_sub_32;
-    logic [63:0]  r_add_64, r_sub_64;
-    logic         vsat_add_8, vsat_add_16, vsat_add_32, vsat_add_64;
-    logic         vsat_sub_8, vsat_sub_16, vsat_sub_32, vsat_sub_64;
+    // fixed-point operand (sign / zero extended)
+    logic [129:0] fixp_op1, fixp_op2, fixp_op2_wide;
+    logic [  6:0] fixp_shamt, fixp_shamt_wide;
 
     alu_operand_t operand1, operand2, result;
 
@@ -86,72 +86,6 @@ module VPU_alu (
                              $signed({valu_ctrl_i.signext & operand1.w64   [63], operand1.w64   });
             default : less = 1'b0;
         endcase
-
-        vsat_add_8  = (valu_ctrl_i.signext) ? ((sum9 [ 7] ^ operand2.w8 [0][ 7]) & ~(operand1.w8 [0][ 7] ^ operand2.w8 [0][ 7])) : (sum9 [ 8]);
-        vsat_add_16 = (valu_ctrl_i.signext) ? ((sum17[15] ^ operand2.w16[0][15]) & ~(operand1.w16[0][15] ^ operand2.w16[0][15])) : (sum17[16]);
-        vsat_add_32 = (valu_ctrl_i.signext) ? ((sum33[31] ^ operand2.w32[0][31]) & ~(operand1.w32[0][31] ^ operand2.w32[0][31])) : (sum33[32]);
-        vsat_add_64 = (valu_ctrl_i.signext) ? ((sum65[63] ^ operand2.w64   [63]) & ~(operand1.w64   [63] ^ operand2.w64   [63])) : (sum65[64]);
-        vsat_sub_8  = (valu_ctrl_i.signext) ? (^sum9 [ 8: 7]) : (sub9 [ 8]);
-        vsat_sub_16 = (valu_ctrl_i.signext) ? (^sum17[16:15]) : (sub17[16]);
-        vsat_sub_32 = (valu_ctrl_i.signext) ? (^sum33[32:31]) : (sub33[32]);
-        vsat_sub_64 = (valu_ctrl_i.signext) ? (^sum65[64:63]) : (sub65[64]);
-
-        r_add_8  = 8'b0;
-        r_add_16 = 16'b0;
-        r_add_32 = 32'b0;
-        r_add_64 = 64'b0;
-        r_sub_8  = 8'b0;
-        r_sub_16 = 16'b0;
-        r_sub_32 = 32'b0;
-        r_sub_64 = 64'b0;
-
-        unique case (vxrm_i)
-            VXRM_RNU : begin
-                r_add_8  = { 7'd0, sum9 [0]};
-                r_add_16 = {15'd0, sum17[0]};
-                r_add_32 = {31'd0, sum33[0]};
-                r_add_64 = {63'd0, sum65[0]};
-                r_sub_8  = { 7'd0, sub9 [0]};
-                r_sub_16 = {15'd0, sub17[0]};
-                r_sub_32 = {31'd0, sub33[0]};
-                r_sub_64 = {63'd0, sub65[0]};
-            end
-
-            VXRM_RNE : begin
-                r_add_8  = { 7'd0, &sum9 [1:0]};
-                r_add_16 = {15'd0, &sum17[1:0]};
-                r_add_32 = {31'd0, &sum33[1:0]};
-                r_add_64 = {63'd0, &sum65[1:0]};
-                r_sub_8  = { 7'd0, &sub9 [1:0]};
-                r_sub_16 = {15'd0, &sub17[1:0]};
-                r_sub_32 = {31'd0, &sub33[1:0]};
-                r_sub_64 = {63'd0, &sub65[1:0]};
-            end
-
-            VXRM_RDN : begin
-                r_add_8  = { 7'd0, 1'b0};
-                r_add_16 = {15'd0, 1'b0};
-                r_add_32 = {31'd0, 1'b0};
-                r_add_64 = {63'd0, 1'b0};
-                r_sub_8  = { 7'd0, 1'b0};
-                r_sub_16 = {15'd0, 1'b0};
-                r_sub_32 = {31'd0, 1'b0};
-                r_sub_64 = {63'd0, 1'b0};
-            end
-
-            VXRM_ROD : begin
-                r_add_8  = { 7'd0, !sum9 [1] & (sum9 [0] != 1'b0)};
-                r_add_16 = {15'd0, !sum17[1] & (sum17[0] != 1'b0)};
-                r_add_32 = {31'd0, !sum33[1] & (sum33[0] != 1'b0)};
-                r_add_64 = {63'd0, !sum65[1] & (sum65[0] != 1'b0)};
-                r_sub_8  = { 7'd0, !sub9 [1] & (sub9 [0] != 1'b0)};
-                r_sub_16 = {15'd0, !sub17[1] & (sub17[0] != 1'b0)};
-                r_sub_32 = {31'd0, !sub33[1] & (sub33[0] != 1'b0)};
-                r_sub_64 = {63'd0, !sub65[1] & (sub65[0] != 1'b0)};
-            end
-
-            default : ;
-        endcase
     end
 
     always_comb begin
@@ -168,36 +102,6 @@ module VPU_alu (
                 endcase
             end
 
-            VSADD : begin
-                unique case (vsew_i)
-                    VSEW_8  : result.w8 [0] = (vsat_add_8 ) ? ((sum9 [ 7]) ? ({1'b0, { 7{1'b1}}}) : ({1'b1,  7'd0})) : (sum9 [ 7:0]);
-                    VSEW_16 : result.w16[0] = (vsat_add_16) ? ((sum17[15]) ? ({1'b0, {15{1'b1}}}) : ({1'b1, 15'd0})) : (sum17[15:0]);
-                    VSEW_32 : result.w32[0] = (vsat_add_32) ? ((sum33[31]) ? ({1'b0, {31{1'b1}}}) : ({1'b1, 31'd0})) : (sum33[31:0]);
-                    VSEW_64 : result.w64    = (vsat_add_64) ? ((sum65[63]) ? ({1'b0, {63{1'b1}}}) : ({1'b1, 63'd0})) : (sum65[63:0]);
-                    default : ;
-                endcase
-            end
-
-            VSADDU : begin
-                unique case (vsew_i)
-                    VSEW_8  : result.w8 [0] = (vsat_add_8 ) ? ({ 8{1'b1}}) : (sum9 [ 7:0]);
-                    VSEW_16 : result.w16[0] = (vsat_add_16) ? ({16{1'b1}}) : (sum17[15:0]);
-                    VSEW_32 : result.w32[0] = (vsat_add_32) ? ({32{1'b1}}) : (sum33[31:0]);
-                    VSEW_64 : result.w64    = (vsat_add_64) ? ({64{1'b1}}) : (sum65[63:0]);
-                    default : ;
-                endcase
-            end
-
-            VAADD : begin
-                unique case (vsew_i)
-                    VSEW_8  : result.w8 [0] = (valu_ctrl_i.signext) ? ({sum9 [ 7], sum9 [ 7:1]} + r_add_8 ) : (sum9 [ 8:1] + r_add_8 );
-                    VSEW_16 : result.w16[0] = (valu_ctrl_i.signext) ? ({sum17[15], sum17[15:1]} + r_add_16) : (sum17[16:1] + r_add_16);
-                    VSEW_32 : result.w32[0] = (valu_ctrl_i.signext) ? ({sum33[31], sum33[31:1]} + r_add_32) : (sum33[32:1] + r_add_32);
-                    VSEW_64 : result.w64    = (valu_ctrl_i.signext) ? ({sum65[63], sum65[63:1]} + r_add_64) : (sum65[64:1] + r_add_64);
-                    default : ;
-                endcase
-            end
-
             VSUB, VRSUB : begin
                 unique case (vsew_i)
                     VSEW_8  : result.w8 [0] = (valu_ctrl_i.mask_res) ? ({7'd0 , sum9 [ 8]}) : (sub9 [ 7:0]);
@@ -208,26 +112,6 @@ module VPU_alu (
                 endcase
             end
 
-            V_SSUB, V_SSUBU : begin
-                unique case (vsew_i)
-                    VSEW_8  : result.w8 [0] = (vsat_sub_8 ) ? ({ 8{1'b0}}) : (sum9 [ 7:0]);
-                    VSEW_16 : result.w16[0] = (vsat_sub_16) ? ({16{1'b0}}) : (sum17[15:0]);
-                    VSEW_32 : result.w32[0] = (vsat_sub_32) ? ({32{1'b0}}) : (sum33[31:0]);
-                    VSEW_64 : result.w64    = (vsat_sub_64) ? ({64{1'b0}}) : (sum65[63:0]);
-                    default : ;
-                endcase
-            end
-
-            VASUB : begin
-                unique case (vsew_i)
-                    VSEW_8  : result.w8 [0] = (valu_ctrl_i.signext) ? (($signed(sub9 [ 7:0]) >>> 1) + r_sub_8 ) : ((sub9 [ 7:0] >> 1) + r_add_8 );
-                    VSEW_16 : result.w16[0] = (valu_ctrl_i.signext) ? (($signed(sub17[15:0]) >>> 1) + r_sub_16) : ((sub17[15:0] >> 1) + r_add_16);
-                    VSEW_32 : result.w32[0] = (valu_ctrl_i.signext) ? (($signed(sub33[31:0]) >>> 1) + r_sub_32) : ((sub33[31:0] >> 1) + r_add_32);
-                    VSEW_64 : result.w64    = (valu_ctrl_i.signext) ? (($signed(sub65[63:0]) >>> 1) + r_sub_64) : ((sub65[63:0] >> 1) + r_add_64);
-                    default : ;
-                endcase
-            end
-
             VAND : result = operand2 & operand1;
             VOR  : result = operand2 | operand1;
             VXOR : result = operand2 ^ operand1;
@@ -296,4 +180,98 @@ module VPU_alu (
         endcase
     end
 
+    // --------------------------------------------
+    //        Fixed-Point Rounding / Saturation    
+    // --------------------------------------------
+    // saturating / averaging / scaling / clip instructions
+    // send the extended operand to the shared fixed-point stage
+    always_comb begin
+        fixp_op1        = 130'd0;
+        fixp_op2        = 130'd0;
+        fixp_op2_wide   = 130'd0;
+        fixp_shamt      = 7'd0;
+        fixp_shamt_wide = 7'd0;
+
+        unique case (vsew_i)
+            VSEW_8 : begin
+                fixp_op1        = {{122{valu_ctrl_i.signext & operand1.w8 [0][ 7]}}, operand1.w8 [0]};
+                fixp_op2        = {{122{valu_ctrl_i.signext & operand2.w8 [0][ 7]}}, operand2.w8 [0]};
+                fixp_op2_wide   = {{114{valu_ctrl_i.signext & operand2.w16[0][15]}}, operand2.w16[0]};
+                fixp_shamt      = {4'd0, operand1.w8[0][2:0]};
+                fixp_shamt_wide = {3'd0, operand1.w8[0][3:0]};
+            end
+
+            VSEW_16 : begin
+                fixp_op1        = {{114{valu_ctrl_i.signext & operand1.w16[0][15]}}, operand1.w16[0]};
+                fixp_op2        = {{114{valu_ctrl_i.signext & operand2.w16[0][15]}}, operand2.w16[0]};
+                fixp_op2_wide   = {{ 98{valu_ctrl_i.signext & operand2.w32[0][31]}}, operand2.w32[0]};
+                fixp_shamt      = {3'd0, operand1.w16[0][3:0]};
+                fixp_shamt_wide = {2'd0, operand1.w16[0][4:0]};
+            end
+
+            VSEW_32 : begin
+                fixp_op1        = {{ 98{valu_ctrl_i.signext & operand1.w32[0][31]}}, operand1.w32[0]};
+                fixp_op2        = {{ 98{valu_ctrl_i.signext & operand2.w32[0][31]}}, operand2.w32[0]};
+                fixp_op2_wide   = {{ 66{valu_ctrl_i.signext & operand2.w64   [63]}}, operand2.w64   };
+                fixp_shamt      = {2'd0, operand1.w32[0][4:0]};
+                fixp_shamt_wide = {1'd0, operand1.w32[0][5:0]};
+            end
+
+            VSEW_64 : begin
+                fixp_op1        = {{ 66{valu_ctrl_i.signext & operand1.w64   [63]}}, operand1.w64   };
+                fixp_op2        = {{ 66{valu_ctrl_i.signext & operand2.w64   [63]}}, operand2.w64   };
+                fixp_shamt      = {1'd0, operand1.w64[5:0]};
+            end
+
+            default : ;
+        endcase
+
+        fixp_o         = VFIXP_REQ_t'(0);
+        fixp_o.signext = valu_ctrl_i.signext;
+        fixp_o.vsew    = vsew_i;
+        fixp_o.vxrm    = vxrm_i;
+
+        unique case (valu_ctrl_i.op)
+            VSADD, VSADDU : begin
+                fixp_o.valid = valid_i;
+                fixp_o.clip  = 1'b1;
+                fixp_o.value = fixp_op2 + fixp_op1;
+            end
+
+            V_SSUB, V_SSUBU : begin
+                fixp_o.valid = valid_i;
+                fixp_o.clip  = 1'b1;
+                fixp_o.value = fixp_op2 - fixp_op1;
+            end
+
+            VAADD : begin
+                fixp_o.valid = valid_i;
+                fixp_o.shift = 7'd1;
+                fixp_o.value = fixp_op2 + fixp_op1;
+            end
+
+            VASUB : begin
+                fixp_o.valid = valid_i;
+                fixp_o.shift = 7'd1;
+                fixp_o.value = fixp_op2 - fixp_op1;
+            end
+
+            V_SSRL, V_SSRA : begin
+                fixp_o.valid = valid_i;
+                fixp_o.shift = fixp_shamt;
+                fixp_o.value = fixp_op2;
+            end
+
+            // vs2 is 2*SEW wide, the result is clipped to SEW
+            VNCLIP : begin
+                fixp_o.valid = valid_i;
+                fixp_o.clip  = 1'b1;
+                fixp_o.shift = fixp_shamt_wide;
+                fixp_o.value = fixp_op2_wide;
+            end
+
+            default : ; // nothing to do
+        endcase
+    end
+
 endmodule
\ No newline at end of file
@@ -6,12 +6,27 @@ module VPU_cfg (
     input  logic               VCFG_valid_i,
     input  VPU_uOP_t           VCFG_entry_i,
 
+    // from EXE (fixed-point saturation)
+    input  logic               vxsat_set_i,
+
+    // performance events
+    input  VHPM_EVENT_t        hpm_event_i,
+
+    // from ISSUE (a uOP takes vstart when it enters VIQ)
+    input  logic               vstart_take_i,
+
+    // from COMMIT (vector reorder buffer)
+    input  logic               rob_trap_i,
+    input  logic               rob_empty_i,
+    input  logic [VL_BITS-1:0] rob_vstart_i,
+
     // csr value
     output logic [VL_BITS-2:0] vstart_o,
     output logic               vxsat_o,
     output VXRM_e              vxrm_o,
     output VTYPE_CSR_t         vtype_o,
     output logic [VL_BITS-1:0] vl_o,
+    output logic               vrelax_o,
 
     // to COMMIT
     output logic               VCFG_read_valid_o,
@@ -30,6 +45,10 @@ module VPU_cfg (
     VTYPE_CSR_t         vtype_q, vtype_n;     // 6. vector data type register
     logic [31:0]        vlenb;                // 7. VLEN / 8 (vector register length in bytes)
 
+    // VPU status (custom)
+    logic               vrelax_q, vrelax_n;   // vector load / store do not stall CPU
+    logic [31:0]        vpustat;              // {relax, busy}
+
     // if the current CSRs in valid
     logic               vill;                 // should inside vtype, but spec said can use vsew to indicate
 
@@ -40,6 +59,10 @@ module VPU_cfg (
     logic [31:0]        avl;
     logic [VL_BITS-1:0] vlmax;
 
+    // performance counters (read-only, wrap around)
+    logic [31:0]         vhpm_q[VHPM_NUM];
+    logic [VHPM_NUM-1:0] vhpm_inc;
+
     // --------------------------------------------
     //              Output Assignment              
     // --------------------------------------------
@@ -50,6 +73,7 @@ module VPU_cfg (
     assign vxrm_o            = vxrm_q;
     assign vtype_o           = vtype_q;
     assign vl_o              = vl_q;
+    assign vrelax_o          = vrelax_q;
 
     // --------------------------------------------
     //                 CSRs update                 
@@ -61,12 +85,44 @@ module VPU_cfg (
             vxrm_q     <= VXRM_e'(0);
             vtype_q    <= VTYPE_CSR_t'(0);
             vl_q       <= VL_BITS'(0);
+            vrelax_q   <= 1'b0;
         end else begin
             vstart_q   <= vstart_n;
             vxsat_q    <= vxsat_n;
             vxrm_q     <= vxrm_n;
             vtype_q    <= vtype_n;
             vl_q       <= vl_n;
+            vrelax_q   <= vrelax_n;
+        end
+    end
+
+    // --------------------------------------------
+    //            Performance Counters             
+    // --------------------------------------------
+    always_comb begin
+        vhpm_inc                   = VHPM_NUM'(0);
+        vhpm_inc[VHPM_VALU_BUSY  ] = (hpm_event_i.exe_fu == VALU );
+        vhpm_inc[VHPM_VMUL_BUSY  ] = (hpm_event_i.exe_fu == VMUL );
+        vhpm_inc[VHPM_VLSU_BUSY  ] = (hpm_event_i.exe_fu == VLSU );
+        vhpm_inc[VHPM_VSLD_BUSY  ] = (hpm_event_i.exe_fu == VSLD );
+        vhpm_inc[VHPM_VELEM_BUSY ] = (hpm_event_i.exe_fu == VELEM);
+        vhpm_inc[VHPM_VMASK_BUSY ] = (hpm_event_i.exe_fu == VMASK);
+        vhpm_inc[VHPM_VIQ_FULL   ] = hpm_event_i.viq_full;
+        vhpm_inc[VHPM_UNACCEPT   ] = hpm_event_i.unaccept;
+        vhpm_inc[VHPM_DCACHE_WAIT] = hpm_event_i.dcache_wait;
+    end
+
+    always_ff @(posedge clk_i) begin
+        if (rst_i) begin
+            for (int i = 0; i < VHPM_NUM; i++) begin
+                vhpm_q[i] <= 32'd0;
+            end
+        end else begin
+            for (int i = 0; i < VHPM_NUM; i++) begin
+                vhpm_q[i] <= vhpm_q[i] + 32'(vhpm_inc[i]);
+            end
+
+            vhpm_q[VHPM_ELEMENTS] <= vhpm_q[VHPM_ELEMENTS] + 32'(hpm_event_i.elements);
         end
     end
 
@@ -78,6 +134,8 @@ module VPU_cfg (
         vxsat_n    = vxsat_q;
         vxrm_n     = vxrm_q;
         vcsr       = {29'd0, vxrm_q, vxsat_q};
+        vrelax_n   = vrelax_q;
+        vpustat    = {30'd0, vrelax_q, ~rob_empty_i};
         vtype_n    = vtype_q;
         vl_n       = vl_q;
         vill       = (vtype_q.vsew == VSEW_INVALID);
@@ -104,6 +162,10 @@ module VPU_cfg (
                 CFG_VCSR_WRITE   : read_data = vcsr;
                 CFG_VCSR_SET     : read_data = vcsr;
                 CFG_VCSR_CLEAR   : read_data = vcsr;
+                CFG_VHPM_READ    : read_data = (VCFG_entry_i.rs1.xval < VHPM_NUM) ? (vhpm_q[VCFG_entry_i.rs1.xval[3:0]]) : (32'd0);
+                CFG_VPUSTAT_WRITE: read_data = vpustat;
+                CFG_VPUSTAT_SET  : read_data = vpustat;
+                CFG_VPUSTAT_CLEAR: read_data = vpustat;
                 default :        ; // nothing to do
             endcase
 
@@ -120,13 +182,35 @@ module VPU_cfg (
                 CFG_VCSR_WRITE   : {vxrm_n, vxsat_n} =  VCFG_entry_i.rs1.xval[2:0];
                 CFG_VCSR_SET     : {vxrm_n, vxsat_n} =  VCFG_entry_i.rs1.xval[2:0] | {vxrm_q, vxsat_q};
                 CFG_VCSR_CLEAR   : {vxrm_n, vxsat_n} = ~VCFG_entry_i.rs1.xval[2:0] & {vxrm_q, vxsat_q};
+                CFG_VPUSTAT_WRITE: vrelax_n          =  VCFG_entry_i.rs1.xval[1];
+                CFG_VPUSTAT_SET  : vrelax_n          =  VCFG_entry_i.rs1.xval[1] | vrelax_q;
+                CFG_VPUSTAT_CLEAR: vrelax_n          = ~VCFG_entry_i.rs1.xval[1] & vrelax_q;
                 default :        ; // nothing to do
             endcase
         end
 
+        // vxsat is sticky, any saturated element sets it
+        if (vxsat_set_i) begin
+            vxsat_n = 1'b1;
+        end
+
+        // ---------------------------------------------------------
+        // a vector instruction carries vstart with it into the VIQ
+        // and leaves it at zero; a load / store stopped by a trap
+        // sets it to the element the restarted instruction resumes
+        // ---------------------------------------------------------
+        if (vstart_take_i) begin
+            vstart_n = (VL_BITS-1)'(0);
+        end
+
+        if (rob_trap_i) begin
+            vstart_n = rob_vstart_i[VL_BITS-2:0];
+        end
+
         // vset[i]vl[i] instructions update
         if (VCFG_valid_i && VCFG_entry_i.mode.cfg.csr_op == CFG_VSETVL) begin
             vtype_n  = VCFG_entry_i.mode.cfg.vtype;
+            vstart_n = (VL_BITS-1)'(0);
 
             // ---------------------------------------------------------------------------------
             // Note that the spec states:
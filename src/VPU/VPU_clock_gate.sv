@@ -0,0 +1,30 @@
+// --------------------------------------------
+// Clock gate for the VPU execute stage / regfile
+// * synthesis maps it to the N16ADFP integrated
+//   clock gate (latch + AND, E sampled while CP low)
+// * RTL simulation uses a behavioural model of the cell
+// --------------------------------------------
+module VPU_clock_gate (
+    input  logic clk_i,
+    input  logic en_i,
+    output logic gclk_o
+);
+
+`ifdef SYNTHESIS
+    CKLNQD1BWP16P90LVT i_ICG (
+        .CP ( clk_i  ),
+        .E  ( en_i   ),
+        .TE ( 1'b0   ),
+        .Q  ( gclk_o )
+    );
+`else
+    logic en_latch;
+
+    always_latch begin
+        if (~clk_i) en_latch <= en_i;
+    end
+
+    assign gclk_o = clk_i & en_latch;
+`endif
+
+endmodule
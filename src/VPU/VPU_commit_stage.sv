@@ -1,24 +1,53 @@
 module VPU_commit_stage (
-    input  logic        clk_i,
-    input  logic        rst_i,
+    input  logic               clk_i,
+    input  logic               rst_i,
 
     // from VCFG unit
-    input  logic        VCFG_read_valid_i,
-    input  logic [31:0] VCFG_read_data_i,
-    output logic        VCFG_commit_o,
+    input  logic               VCFG_read_valid_i,
+    input  logic [31:0]        VCFG_read_data_i,
+    output logic               VCFG_commit_o,
+
+    // from ISSUE (allocate in program order when a uOP enters VIQ)
+    input  logic               rob_alloc_i,
+    input  logic               rob_alloc_lsu_i,
+
+    // from ID (a trap restarts the youngest uOP, stop it)
+    input  logic               rob_squash_i,
 
     // from EXE
-    input  logic        lsu_commit_i,
+    input  logic               exe_busy_i,
+    input  logic               exe_done_i,
+    input  logic [VL_BITS-1:0] exe_progress_i,
+    input  logic               xreg_result_valid_i,
+    input  logic [31:0]        xreg_result_i,
+
+    // to EXE / ID
+    output logic               exe_kill_o,          // stop the uOP in execute stage
+    output logic               rob_kill_pending_o,  // a stopped uOP has not retired yet
+
+    // to VCFG unit
+    output logic               rob_retire_o,  // a vector instruction finished
+    output logic               rob_trap_o,    // a stopped uOP retired, it resumes at rob_vstart_o
+    output logic [VL_BITS-1:0] rob_vstart_o,  // progress of the retiring uOP
+    output logic               rob_empty_o,
 
     // writeback to CPU
-    output logic        vector_lsu_valid_o,
-    output logic        vector_result_valid_o,
-    output logic [31:0] vector_result_o
+    output logic               vector_lsu_valid_o,
+    output logic               vector_result_valid_o,
+    output logic [31:0]        vector_result_o
 );
 
     // --------------------------------------------
     //              Signal Declaration             
     // --------------------------------------------
+    // vector reorder buffer
+    VROB_ENTRY_t              ROB_q[VROB_DEPTH], ROB_n[VROB_DEPTH];
+    logic [VROB_TAG_BITS  :0] rob_size_q, rob_size_n;
+    logic [VROB_TAG_BITS-1:0] head_ptr_q, head_ptr_n; // oldest uOP (next to retire)
+    logic [VROB_TAG_BITS-1:0] tail_ptr_q, tail_ptr_n; // next free entry
+    logic [VROB_TAG_BITS-1:0] exe_ptr_q, exe_ptr_n;   // oldest uOP not finished
+    logic                     retire;
+    logic                     kill_pending_q, kill_pending_n;
 
     // --------------------------------------------
     //           VPU <-> CPU commit logic          
@@ -33,11 +62,107 @@ module VPU_commit_stage (
             vector_result_valid_o = 1'b1;
             vector_result_o       = VCFG_read_data_i;
         end
+
+        // scalar result from execute stage (vcpop / vfirst), dropped if the CPU restarts it
+        if (xreg_result_valid_i && ~exe_kill_o) begin
+            vector_result_valid_o = 1'b1;
+            vector_result_o       = xreg_result_i;
+        end
     end
 
     // --------------------------------------------
-    //          VPU internal commit logic          
+    //            Vector Reorder Buffer            
     // --------------------------------------------
-    assign vector_lsu_valid_o = lsu_commit_i;
+    // ---------------------------------------------------------------
+    // uOPs enter in program order, the execute stage finishes them,
+    // and they retire from the head in order. A vector load / store
+    // is reported to CPU only when it retires.
+    //
+    // A trap restarts the youngest vector instruction (the one CPU
+    // waits for in MEM). If it is already in VIQ / execute stage it
+    // is marked kill : a load / store stops at the next element, and
+    // when it retires its progress is the vstart it resumes at. New
+    // instructions wait until then, so they see the precise vstart.
+    // ---------------------------------------------------------------
+    assign rob_empty_o        = (rob_size_q == (VROB_TAG_BITS+1)'(0));
+    assign rob_vstart_o       = ROB_n[head_ptr_q].progress;
+    assign rob_retire_o       = retire;
+    assign rob_trap_o         = retire && ROB_n[head_ptr_q].kill;
+    assign vector_lsu_valid_o = retire && ROB_n[head_ptr_q].lsu && ~ROB_n[head_ptr_q].kill;
+    assign exe_kill_o         = ROB_q[exe_ptr_q].valid && ROB_q[exe_ptr_q].kill;
+    assign rob_kill_pending_o = kill_pending_q;
+
+    always_comb begin
+        ROB_n      = ROB_q;
+        rob_size_n = rob_size_q;
+        head_ptr_n = head_ptr_q;
+        tail_ptr_n = tail_ptr_q;
+        exe_ptr_n  = exe_ptr_q;
+        retire     = 1'b0;
+
+        kill_pending_n = kill_pending_q;
+
+        // execute stage works on the oldest unfinished uOP
+        if (exe_busy_i && ROB_q[exe_ptr_q].valid && ~ROB_q[exe_ptr_q].done) begin
+            ROB_n[exe_ptr_q].progress = exe_progress_i;
+
+            if (exe_done_i) begin
+                ROB_n[exe_ptr_q].done = 1'b1;
+                exe_ptr_n             = exe_ptr_q + VROB_TAG_BITS'(1);
+            end
+        end
+
+        // the youngest uOP is stopped unless it has already finished
+        if (rob_squash_i && ROB_q[tail_ptr_q - VROB_TAG_BITS'(1)].valid && ~ROB_n[tail_ptr_q - VROB_TAG_BITS'(1)].done) begin
+            ROB_n[tail_ptr_q - VROB_TAG_BITS'(1)].kill = 1'b1;
+            kill_pending_n                             = 1'b1;
+        end
+
+        // retire in order (a uOP can finish and retire in the same cycle)
+        if (ROB_n[head_ptr_q].valid && ROB_n[head_ptr_q].done) begin
+            retire                  = 1'b1;
+            ROB_n[head_ptr_q].valid = 1'b0;
+            head_ptr_n              = head_ptr_q + VROB_TAG_BITS'(1);
+
+            if (ROB_n[head_ptr_q].kill) begin
+                kill_pending_n = 1'b0;
+            end
+        end
+
+        // allocate (VROB_DEPTH covers VIQ and execute stage, so it never fills)
+        if (rob_alloc_i) begin
+            ROB_n[tail_ptr_q] = {1'b1, 1'b0, rob_alloc_lsu_i, 1'b0, VL_BITS'(0)};
+            tail_ptr_n        = tail_ptr_q + VROB_TAG_BITS'(1);
+        end
+
+        unique case ({rob_alloc_i, retire})
+            2'b01   : rob_size_n = rob_size_q - (VROB_TAG_BITS+1)'(1);
+            2'b10   : rob_size_n = rob_size_q + (VROB_TAG_BITS+1)'(1);
+            default : ; // nothing to do
+        endcase
+    end
+
+    always_ff @(posedge clk_i) begin
+        if (rst_i) begin
+            foreach (ROB_q[i]) begin
+                ROB_q[i] <= VROB_ENTRY_t'(0);
+            end
+
+            rob_size_q <= (VROB_TAG_BITS+1)'(0);
+            head_ptr_q <= VROB_TAG_BITS'(0);
+            tail_ptr_q <= VROB_TAG_BITS'(0);
+            exe_ptr_q  <= VROB_TAG_BITS'(0);
+
+            kill_pending_q <= 1'b0;
+        end else begin
+            ROB_q      <= ROB_n;
+            rob_size_q <= rob_size_n;
+            head_ptr_q <= head_ptr_n;
+            tail_ptr_q <= tail_ptr_n;
+            exe_ptr_q  <= exe_ptr_n;
+
+            kill_pending_q <= kill_pending_n;
+        end
+    end
 
-endmodule
\ No newline at end of file
+endmodule
@@ -78,6 +78,7 @@ module VPU_decoder (
         decode_instr.rd         = VD_REG_t'(0);
         decode_instr.widenarrow = OP_WIDENARROW_e'(0);
         decode_instr.vxrm       = VXRM_e'(0);
+        decode_instr.vstart     = VL_BITS'(0);
 
         unique case (opcode)
             // vector CSRs read write
@@ -126,6 +127,13 @@ module VPU_decoder (
                     {CSRRC_FUNC3 , CSR_VCSR  } : decode_instr.mode.cfg.csr_op = CFG_VCSR_CLEAR;
                     {CSRRCI_FUNC3, CSR_VCSR  } : decode_instr.mode.cfg.csr_op = CFG_VCSR_CLEAR;
 
+                    {CSRRW_FUNC3 , CSR_VPUSTAT} : decode_instr.mode.cfg.csr_op = CFG_VPUSTAT_WRITE;
+                    {CSRRWI_FUNC3, CSR_VPUSTAT} : decode_instr.mode.cfg.csr_op = CFG_VPUSTAT_WRITE;
+                    {CSRRS_FUNC3 , CSR_VPUSTAT} : decode_instr.mode.cfg.csr_op = CFG_VPUSTAT_SET;
+                    {CSRRSI_FUNC3, CSR_VPUSTAT} : decode_instr.mode.cfg.csr_op = CFG_VPUSTAT_SET;
+                    {CSRRC_FUNC3 , CSR_VPUSTAT} : decode_instr.mode.cfg.csr_op = CFG_VPUSTAT_CLEAR;
+                    {CSRRCI_FUNC3, CSR_VPUSTAT} : decode_instr.mode.cfg.csr_op = CFG_VPUSTAT_CLEAR;
+
                     // read only CSR
                     {CSRRS_FUNC3 , CSR_VL}, {CSRRSI_FUNC3, CSR_VL},
                     {CSRRC_FUNC3 , CSR_VL}, {CSRRCI_FUNC3, CSR_VL} : begin
@@ -145,10 +153,27 @@ module VPU_decoder (
                         illegal_instr                = (vs1 != x0); // attempts to write read-only CSR
                     end
 
-                    default : illegal_instr = 1'b1;
+                    default : begin
+                        // performance counters (read-only)
+                        if ((f3 inside {CSRRS_FUNC3, CSRRSI_FUNC3, CSRRC_FUNC3, CSRRCI_FUNC3}) &&
+                            (inst[31:20] inside {[CSR_VHPM_BASE : CSR_VHPM_LAST]})) begin
+                            decode_instr.mode.cfg.csr_op = CFG_VHPM_READ;
+                            decode_instr.rs1.xval        = 32'(inst[31:20] - CSR_VHPM_BASE);
+                            illegal_instr                = (vs1 != x0); // attempts to write read-only CSR
+                        end else begin
+                            illegal_instr = 1'b1;
+                        end
+                    end
                 endcase
             end
 
+            // fence (orders vector memory with scalar memory)
+            FENCE_OP : begin
+                decode_instr.fu              = VCFG;
+                decode_instr.mode.cfg.csr_op = CFG_VFENCE;
+                illegal_instr                = (f3 != FENCE_FUNC3);
+            end
+
             // vector load/store (use LOAD-FP and STORE-FP)
             FLW_OP, FSW_OP : begin
                 decode_instr.fu               = VLSU;
@@ -200,6 +225,14 @@ module VPU_decoder (
                             // fault-only-first load
                             5'b10000 : illegal_instr = (opcode == FSW_OP); // illegal for stores
 
+                            // prefetch hint (custom, reserved lumop) : start D$ line fills of
+                            // [rs1, rs1 + vl * eew) without writing vd
+                            5'b00001 : begin
+                                illegal_instr                  = (opcode == FSW_OP); // illegal for stores
+                                decode_instr.mode.lsu.prefetch = 1'b1;
+                                decode_instr.rd.vreg           = 1'b0;
+                            end
+
                             // whole register load/store
                             5'b01000 : begin
                                 emul_override                 = 1'b1;
@@ -667,17 +700,48 @@ module VPU_decoder (
                         end
 
                         // 18. Vector Single-Width Scaling Shift Instructions
-                        // * IMPORTANT : we not yet support this one
-                        V_SSRL_VV, V_SSRL_VI, V_SSRL_VX,
+                        V_SSRL_VV, V_SSRL_VI, V_SSRL_VX : begin
+                            decode_instr.fu               = VALU;
+                            decode_instr.mode.alu.op      = V_SSRL;
+                            decode_instr.mode.alu.op_mask = (masked) ? (VALU_MASK_WRITE) : (VALU_MASK_NONE);
+                            decode_instr.vxrm             = vxrm_i;
+                        end
+
                         V_SSRA_VV, V_SSRA_VI, V_SSRA_VX : begin
-                            illegal_instr = 1'b1;
+                            decode_instr.fu               = VALU;
+                            decode_instr.mode.alu.op      = V_SSRA;
+                            decode_instr.mode.alu.op_mask = (masked) ? (VALU_MASK_WRITE) : (VALU_MASK_NONE);
+                            decode_instr.mode.alu.signext = 1'b1;
+                            decode_instr.vxrm             = vxrm_i;
                         end
 
                         // 19. Vector Narrowing Fixed-Point Clip Instructions
-                        // * IMPORTANT : we not yet support widening or narrowing instruction
+                        // vs2 is a 2*SEW vreg group, so the EMUL used for checking
+                        // vs2 is 2*LMUL and vs1 / vd use the narrow register mask
                         VNCLIPU_VV, VNCLIPU_VI, VNCLIPU_VX,
                         VNCLIP_VV , VNCLIP_VI , VNCLIP_VX : begin
-                            illegal_instr = 1'b1;
+                            decode_instr.fu               = VALU;
+                            decode_instr.mode.alu.op      = VNCLIP;
+                            decode_instr.mode.alu.op_mask = (masked) ? (VALU_MASK_WRITE) : (VALU_MASK_NONE);
+                            decode_instr.mode.alu.signext = (vop inside {VNCLIP_VV, VNCLIP_VI, VNCLIP_VX});
+                            decode_instr.widenarrow       = OP_NARROWING;
+                            decode_instr.vxrm             = vxrm_i;
+                            emul_override                 = 1'b1;
+
+                            unique case (vlmul_i)
+                                LMUL_F8 : emul          = LMUL_F4;
+                                LMUL_F4 : emul          = LMUL_F2;
+                                LMUL_F2 : emul          = LMUL_1;
+                                LMUL_1  : emul          = LMUL_2;
+                                LMUL_2  : emul          = LMUL_4;
+                                LMUL_4  : emul          = LMUL_8;
+                                default : illegal_instr = 1'b1;
+                            endcase
+
+                            // no 2*SEW source for SEW = 64
+                            if (vsew_i == VSEW_64) begin
+                                illegal_instr = 1'b1;
+                            end
                         end
 
                         // --------------------------------------------
@@ -784,37 +848,47 @@ module VPU_decoder (
                             decode_instr.mode.mask.op = VMXNOR;
                         end
 
-                        /*
                         // 23. vmsbf, vmsof, vmsif, viota, vid
                         VMUNARY0_VV : begin
-                            if (vs1[4]) begin
-                                decode_instr.fu               = VELEM;
-                                decode_instr.mode.elem.op     = (vs1[0]) ? (VELEM_VID) : (VELEM_VIOTA);
-                                decode_instr.mode.elem.masked = masked;
-                                decode_instr.rs1.vreg         = 1'b0;
-                                decode_instr.rs2.vreg         = ~vs1[0]; // vid has no rs2
-
-                                illegal_instr = (vs1[3:1] != 3'b000);
+                            decode_instr.fu               = VMASK;
+                            decode_instr.mode.mask.masked = masked;
+                            decode_instr.rs1.vreg         = 1'b0;
+
+                            unique case (vs1)
+                                5'b00001 : decode_instr.mode.mask.op = VMSBF;
+                                5'b00010 : decode_instr.mode.mask.op = VMSOF;
+                                5'b00011 : decode_instr.mode.mask.op = VMSIF;
+                                5'b10000 : decode_instr.mode.mask.op = VIOTA;
+                                5'b10001 : decode_instr.mode.mask.op = VID;
+                                default  : illegal_instr             = 1'b1;
+                            endcase
+
+                            // vid has no vs2 (must be encoded as v0)
+                            if (vs1 == 5'b10001) begin
+                                decode_instr.rs2.vreg = 1'b0;
+                                illegal_instr         = (vs2 != x0);
+                            end
+
+                            // the destination can not overlap the source or the mask
+                            if ((vs1 != 5'b10001 && vd == vs2) || (masked && vd == x0)) begin
+                                illegal_instr = 1'b1;
                             end
                         end
 
                         // 24. vmv.x.s(permutation), vpopc(mask), vfirst(mask)
                         VWXUNARY0_VV : begin
-                            decode_instr.fu = VELEM;
+                            decode_instr.fu               = VMASK;
+                            decode_instr.mode.mask.masked = masked;
+                            decode_instr.mode.mask.xreg   = 1'b1;
+                            decode_instr.rs1.vreg         = 1'b0;
+                            decode_instr.rd.vreg          = 1'b0;
 
                             unique case (vs1)
-                                5'b00000 : decode_instr.mode.elem.op = VELEM_XMV;
-                                5'b10000 : decode_instr.mode.elem.op = VELEM_VPOPC;
-                                5'b10001 : decode_instr.mode.elem.op = VELEM_VFIRST;
-                                default  : illegal_instr = 1'b1;
+                                5'b10000 : decode_instr.mode.mask.op = VCPOP;
+                                5'b10001 : decode_instr.mode.mask.op = VFIRST;
+                                default  : illegal_instr             = 1'b1; // vmv.x.s not yet support
                             endcase
-
-                            decode_instr.mode.elem.xreg   = 1'b1;
-                            decode_instr.mode.elem.masked = masked;
-                            decode_instr.rs1.vreg         = 1'b0;
-                            decode_instr.rd.vreg          = 1'b0;
                         end
-                        */
 
                         // --------------------------------------------
                         //       Vector Permutation Instructions       
@@ -1086,7 +1160,7 @@ module VPU_decoder (
             end
 
             OP_NARROWING : begin
-                rs1_invalid = (vs1 & {2'b00, reg_mask       }) != x0;
+                rs1_invalid = (vs1 & {2'b00, reg_mask_narrow}) != x0;
                 rs2_invalid = (vs2 & {2'b00, reg_mask       }) != x0;
                 rd_invalid  = (vd  & {2'b00, reg_mask_narrow}) != x0;
             end
@@ -1119,6 +1193,17 @@ module VPU_decoder (
             endcase
         end
 
+        if (decode_instr.fu == VMASK) begin
+            // mask sources are always a single vreg, and only viota / vid
+            // write a vreg group rather than a single mask vreg
+            rs1_invalid = 1'b0;
+            rs2_invalid = 1'b0;
+
+            if (~(decode_instr.mode.mask.op inside {VIOTA, VID})) begin
+                rd_invalid = 1'b0;
+            end
+        end
+
         // register addresses are always valid if it is not a vector register:
         if (~decode_instr.rs1.vreg) rs1_invalid = 1'b0;
         if (~decode_instr.rs2.vreg) rs2_invalid = 1'b0;
@@ -6,29 +6,69 @@ module VPU_execute_stage (
     input  logic                 dispatch_valid_i,
     input  VPU_uOP_t             dispatch_entry_i,
     output logic                 dispatch_ready_o,
+    output logic                 exe_idle_o,
+    input  logic                 exe_kill_i,       // stopped by a trap (from COMMIT)
 
-    // to regfile (8 read port, 1 write port)
-    output logic [2:0][4:0]      vreg_read_addr_o,
-    input  logic [2:0][VLEN-1:0] vreg_read_data_i,
-    input  logic [VLEN-1:0]      vreg_v0_i,
+    // to regfile (3 slice group read port, 1 slice group write port)
+    output logic [2:0][4:0]          vreg_read_addr_o,
+    input  logic [2:0][VGRP_LEN-1:0] vreg_read_data_i,
+    input  logic [VLEN-1:0]          vreg_v0_i,
 
-    output logic                 vreg_write_en_o,
-    output logic [4:0]           vreg_write_addr_o,
-    output logic [VLEN/8-1:0]    vreg_write_bweb_o,
-    output logic [VLEN-1:0]      vreg_write_data_o,
+    output logic                     vreg_write_en_o,
+    output logic [4:0]               vreg_write_addr_o,
+    output logic [VGRP_LEN/8-1:0]    vreg_write_bweb_o,
+    output logic [VGRP_LEN-1:0]      vreg_write_data_o,
 
     // request to D$
     output logic                 dcache_vpu_request_o,
     output logic [ 3:0]          dcache_vpu_write_o,
     output logic [31:0]          dcache_vpu_addr_o,
     output logic [31:0]          dcache_vpu_in_o,
+    output logic                 dcache_vpu_inv_o,
+
+    // prefetch hint to D$
+    output logic                 dcache_pf_request_o,
+    output logic [31:0]          dcache_pf_addr_o,
+    output logic [31:0]          dcache_pf_end_o,
 
     // response from D$
     input  logic                 dcache_vpu_wait_i,
     input  logic [31:0]          dcache_vpu_out_i,
-
-    // lsu commit
-    output logic                 lsu_commit_o
+    input  logic                 dcache_sb_empty_i, // buffered D$ stores are in memory
+
+    // non-temporal burst (bypass D$)
+    output logic                 nt_request_o,
+    output logic                 nt_write_o,
+    output logic [31:0]          nt_addr_o,
+    output logic [ 3:0]          nt_len_o,
+    output logic [31:0]          nt_in_o,
+    output logic [ 3:0]          nt_strb_o,
+    input  logic                 nt_in_ready_i,
+    input  logic                 nt_wait_i,
+    input  logic                 nt_out_valid_i,
+    input  logic [31:0]          nt_out_i,
+
+    // vector scratchpad (bypass D$ and AXI)
+    output logic                 spm_request_o,
+    output logic [ 7:0]          spm_write_o,
+    output logic [31:0]          spm_addr_o,
+    output logic [63:0]          spm_in_o,
+    input  logic [63:0]          spm_out_i,
+
+    // to COMMIT (reorder buffer progress)
+    output logic                 exe_done_o,
+    output logic [VL_BITS-1:0]   exe_progress_o,
+
+    // scalar result commit
+    output logic                 xreg_result_valid_o,
+    output logic [31:0]          xreg_result_o,
+
+    // fixed-point saturation to vxsat
+    output logic                 vxsat_set_o,
+
+    // performance events
+    output VPU_FU_t              hpm_exe_fu_o,
+    output logic [VL_BITS-1:0]   hpm_elements_o
 );
 
     // --------------------------------------------
@@ -54,17 +94,20 @@ module VPU_execute_stage (
 
     // operand collection
     logic [4:0]         vreg_addr_offset;
-    logic [63:0]        rs1_val_q, rs2_val_q, rs3_val_q;
-    logic [63:0]        rs1_val_n, rs2_val_n, rs3_val_n;
+    logic [4:0]         vreg_wide_offset; // offset of the 2*SEW source when narrowing
+    logic [VGRP_LEN-1:0] rs1_val_q, rs2_val_q, rs3_val_q; // slice group (lanes may use all of it)
+    logic [VGRP_LEN-1:0] rs1_val_n, rs2_val_n, rs3_val_n;
 
     // lane installation
     logic               lane_valid;
+    logic               lane_narrow;
     logic               lane_done;
     logic [VL_BITS-1:0] lane_vl_update;
     logic               lane_result_valid;
     logic [4:0]         lane_result_addr;
-    logic [VLEN/8-1:0]  lane_result_bweb;
-    logic [VLEN-1:0]    lane_result_data;
+    logic [VGRP_LEN/8-1:0] lane_result_bweb; // slice group
+    logic [VGRP_LEN-1:0]   lane_result_data;
+    logic               lane_vxsat;
 
     // lsu signal
     logic               lsu_valid;
@@ -72,8 +115,8 @@ module VPU_execute_stage (
     logic [VL_BITS-1:0] lsu_vl_update;
     logic               lsu_result_valid;
     logic [4:0]         lsu_result_addr;
-    logic [VLEN/8-1:0]  lsu_result_bweb;
-    logic [VLEN-1:0]    lsu_result_data;
+    logic [VLEN/4-1:0]  lsu_result_bweb; // two slices (unaligned unit-stride)
+    logic [2*VLEN-1:0]  lsu_result_data;
 
     // sld signal
     logic               sld_valid;
@@ -103,6 +146,8 @@ module VPU_execute_stage (
     logic [4:0]         mask_result_addr;
     logic [VLEN/8-1:0]  mask_result_bweb;
     logic [VLEN-1:0]    mask_result_data;
+    logic               mask_xreg_valid;
+    logic [31:0]        mask_xreg_result;
 
     // --------------------------------------------
     //            Execute state control            
@@ -111,9 +156,9 @@ module VPU_execute_stage (
         if (rst_i) begin
             exe_state_q <= state_t'(0);
             vl_count_q  <= VL_BITS'(0);
-            rs1_val_q   <= 64'd0;
-            rs2_val_q   <= 64'd0;
-            rs3_val_q   <= 64'd0;
+            rs1_val_q   <= VGRP_LEN'(0);
+            rs2_val_q   <= VGRP_LEN'(0);
+            rs3_val_q   <= VGRP_LEN'(0);
         end else begin
             exe_state_q <= exe_state_n;
             vl_count_q  <= vl_count_n;
@@ -123,13 +168,18 @@ module VPU_execute_stage (
         end
     end
 
+    assign exe_idle_o     = ~exe_state_q.valid;
+    assign exe_done_o     = exe_state_q.valid && (lane_done || lsu_done || mask_done || sld_done || elem_done);
+    assign hpm_exe_fu_o   = (exe_state_q.valid) ? (exe_state_q.fu) : (VNONE);
+
     always_comb begin
         exe_state_n      = exe_state_q;
         vl_count_n       = vl_count_q;
         
         // default assignment
         dispatch_ready_o = ~exe_state_q.valid;
-        lsu_commit_o     = 1'b0;
+        hpm_elements_o   = VL_BITS'(0);
+        exe_progress_o   = VL_BITS'(0);
 
         // execute unit installation
         lane_valid = exe_state_q.valid && exe_state_q.fu inside {VALU, VMUL};
@@ -153,11 +203,14 @@ module VPU_execute_stage (
 
             // ensure we don't exceed the actual VL
             if (vl_count_n >= exe_state_q.vl) vl_count_n = exe_state_q.vl;
+            hpm_elements_o = vl_count_n - vl_count_q;
+
+            // elements written back, a load / store stopped by a trap resumes here
+            exe_progress_o = (vl_count_n < exe_state_q.vl) ? (vl_count_n) : (VL_BITS'(0));
 
             // check if done (execute unit handshake)
             if (lane_done || lsu_done || mask_done || sld_done || elem_done) begin
                 dispatch_ready_o  = 1'b1;
-                lsu_commit_o      = lsu_done;
                 exe_state_n       = state_t'(0);
             end
         end
@@ -177,7 +230,10 @@ module VPU_execute_stage (
             exe_state_n.emul       = dispatch_entry_i.emul;
             exe_state_n.vxrm       = dispatch_entry_i.vxrm;
             exe_state_n.vl         = dispatch_entry_i.vl;
-            vl_count_n             = VL_BITS'(0);
+
+            // a load / store restarted after a trap skips the elements before vstart,
+            // other units always start from element 0
+            vl_count_n             = (dispatch_entry_i.fu == VLSU) ? (dispatch_entry_i.vstart) : (VL_BITS'(0));
         end
     end
 
@@ -187,8 +243,10 @@ module VPU_execute_stage (
     // set up register read address
     always_comb begin
         vreg_addr_offset = 5'd0;
+        vreg_wide_offset = 5'd0;
 
-        unique case (exe_state_q.eew)
+        // next eew, so a new entry reads the slice at its first element
+        unique case (exe_state_n.eew)
             VSEW_8  : vreg_addr_offset = vl_count_n >> 5'd3;
             VSEW_16 : vreg_addr_offset = vl_count_n >> 5'd2;
             VSEW_32 : vreg_addr_offset = vl_count_n >> 5'd1;
@@ -196,16 +254,34 @@ module VPU_execute_stage (
             default : ;
         endcase
 
+        unique case (exe_state_q.eew)
+            VSEW_8  : vreg_wide_offset = vl_count_n >> 5'd2;
+            VSEW_16 : vreg_wide_offset = vl_count_n >> 5'd1;
+            VSEW_32 : vreg_wide_offset = vl_count_n[4:0];
+            default : ;
+        endcase
+
         // default read address
         vreg_read_addr_o[0] = exe_state_q.rs1_index + vreg_addr_offset;
         vreg_read_addr_o[1] = exe_state_q.rs2_index + vreg_addr_offset;
         vreg_read_addr_o[2] = exe_state_q.rd_index  + vreg_addr_offset;
 
+        // vs2 of narrowing instructions has 2*SEW elements
+        if (exe_state_q.widenarrow == OP_NARROWING) begin
+            vreg_read_addr_o[1] = exe_state_q.rs2_index + vreg_wide_offset;
+        end
+
+        // mask sources are a single vreg for the whole instruction
+        if (mask_valid) begin
+            vreg_read_addr_o[0] = exe_state_q.rs1_index;
+            vreg_read_addr_o[1] = exe_state_q.rs2_index;
+        end
+
         // set up read when new entry comes
         if (dispatch_valid_i) begin
-            vreg_read_addr_o[0] = dispatch_entry_i.rs1.index;
-            vreg_read_addr_o[1] = dispatch_entry_i.rs2.index;
-            vreg_read_addr_o[2] = dispatch_entry_i.rd.index;
+            vreg_read_addr_o[0] = dispatch_entry_i.rs1.index + vreg_addr_offset;
+            vreg_read_addr_o[1] = dispatch_entry_i.rs2.index + vreg_addr_offset;
+            vreg_read_addr_o[2] = dispatch_entry_i.rd.index  + vreg_addr_offset;
         end
 
         if (sld_valid) begin
@@ -227,9 +303,9 @@ module VPU_execute_stage (
 
         // save read data when new entry comes
         if (dispatch_valid_i) begin
-            rs1_val_n = (exe_state_n.vreg[0]) ? (vreg_read_data_i[0]) : ({{32{dispatch_entry_i.rs1.xval[31]}}, dispatch_entry_i.rs1.xval});
-            rs2_val_n = (exe_state_n.vreg[1]) ? (vreg_read_data_i[1]) : ({{32{dispatch_entry_i.rs2.xval[31]}}, dispatch_entry_i.rs2.xval});
-            rs3_val_n = (exe_state_n.vreg[2]) ? (vreg_read_data_i[2]) : (64'd0);
+            rs1_val_n = (exe_state_n.vreg[0]) ? (vreg_read_data_i[0]) : (VGRP_LEN'({{32{dispatch_entry_i.rs1.xval[31]}}, dispatch_entry_i.rs1.xval}));
+            rs2_val_n = (exe_state_n.vreg[1]) ? (vreg_read_data_i[1]) : (VGRP_LEN'({{32{dispatch_entry_i.rs2.xval[31]}}, dispatch_entry_i.rs2.xval}));
+            rs3_val_n = (exe_state_n.vreg[2]) ? (vreg_read_data_i[2]) : (VGRP_LEN'(0));
         end
     end
 
@@ -237,8 +313,8 @@ module VPU_execute_stage (
     always_comb begin
         vreg_write_en_o   = 1'b0;
         vreg_write_addr_o = 5'd0;
-        vreg_write_bweb_o = (VLEN/8)'(0);
-        vreg_write_data_o = VLEN'(0);
+        vreg_write_bweb_o = (VGRP_LEN/8)'(0);
+        vreg_write_data_o = VGRP_LEN'(0);
 
         if (lane_result_valid && ~lane_done) begin
             vreg_write_en_o   = 1'b1;
@@ -250,35 +326,37 @@ module VPU_execute_stage (
         if (lsu_result_valid && ~lsu_done) begin
             vreg_write_en_o   = 1'b1;
             vreg_write_addr_o = lsu_result_addr;
-            vreg_write_bweb_o = lsu_result_bweb;
-            vreg_write_data_o = lsu_result_data;
+            vreg_write_bweb_o = (VGRP_LEN/8)'(lsu_result_bweb);
+            vreg_write_data_o = VGRP_LEN'(lsu_result_data);
         end
 
         if (sld_result_valid && ~sld_done) begin
             vreg_write_en_o   = 1'b1;
             vreg_write_addr_o = sld_result_addr;
-            vreg_write_bweb_o = sld_result_bweb;
-            vreg_write_data_o = sld_result_data;
+            vreg_write_bweb_o = (VGRP_LEN/8)'(sld_result_bweb);
+            vreg_write_data_o = VGRP_LEN'(sld_result_data);
         end
 
         if (elem_result_valid && ~elem_done) begin
             vreg_write_en_o   = 1'b1;
             vreg_write_addr_o = elem_result_addr;
-            vreg_write_bweb_o = elem_result_bweb;
-            vreg_write_data_o = elem_result_data;
+            vreg_write_bweb_o = (VGRP_LEN/8)'(elem_result_bweb);
+            vreg_write_data_o = VGRP_LEN'(elem_result_data);
         end
 
         if (mask_result_valid && ~mask_done) begin
             vreg_write_en_o   = 1'b1;
             vreg_write_addr_o = mask_result_addr;
-            vreg_write_bweb_o = mask_result_bweb;
-            vreg_write_data_o = mask_result_data;
+            vreg_write_bweb_o = (VGRP_LEN/8)'(mask_result_bweb);
+            vreg_write_data_o = VGRP_LEN'(mask_result_data);
         end
     end
 
     // --------------------------------------------
     //                     Lane                    
     // --------------------------------------------
+    assign lane_narrow = (exe_state_q.widenarrow == OP_NARROWING);
+
     VPU_lane_wrapper i_VPU_lane_wrapper (
         .clk_i,
         .rst_i,
@@ -293,6 +371,7 @@ module VPU_execute_stage (
         .vsew_i         ( exe_state_q.eew      ),
         .vxrm_i         ( exe_state_q.vxrm     ),
         .rd_addr_i      ( exe_state_q.rd_index ),
+        .narrow_i       ( lane_narrow          ),
         .done_o         ( lane_done            ),
 
         // input operand source
@@ -306,9 +385,12 @@ module VPU_execute_stage (
         .result_valid_o ( lane_result_valid    ),
         .result_addr_o  ( lane_result_addr     ),
         .result_data_o  ( lane_result_data     ),
-        .result_bweb_o  ( lane_result_bweb     )
+        .result_bweb_o  ( lane_result_bweb     ),
+        .vxsat_o        ( lane_vxsat           )
     );
 
+    assign vxsat_set_o = lane_valid && lane_vxsat;
+
     // --------------------------------------------
     //                     VLSD                    
     // --------------------------------------------
@@ -330,8 +412,8 @@ module VPU_execute_stage (
 
         // input operand source
         .offset_i        ( rs1_val_q[VL_BITS-1:0] ),
-        .rs1_val_i       ( rs1_val_q              ),
-        .rs2_val_i       ( rs2_val_q              ),
+        .rs1_val_i       ( rs1_val_q[VLEN-1:0]    ),
+        .rs2_val_i       ( rs2_val_q[VLEN-1:0]    ),
         .rs2_read_addr_o ( sld_rs2_read_addr      ),
 
         // output result
@@ -360,8 +442,8 @@ module VPU_execute_stage (
         .done_o          ( elem_done              ),
 
         // input operand source
-        .rs1_val_i       ( rs1_val_q              ),
-        .rs2_val_i       ( rs2_val_q              ),
+        .rs1_val_i       ( rs1_val_q[VLEN-1:0]    ),
+        .rs2_val_i       ( rs2_val_q[VLEN-1:0]    ),
         .rs2_read_addr_o ( elem_rs2_read_addr     ),
 
         // output result
@@ -372,29 +454,40 @@ module VPU_execute_stage (
     );
 
     // --------------------------------------------
-    //          VMASK (finish in one cycle)        
+    //                    VMASK                    
     // --------------------------------------------
-    // generate whole mask
+    // mask logical / vmsbf / vmsif / vmsof / vcpop / vfirst finish in one cycle,
+    // viota / vid write one vd slice per cycle
     VPU_mask i_VPU_mask (
-        .valid_i        ( mask_valid            ),
-        .vmask_ctrl_i   ( exe_state_q.mode.mask ),
-        .vl_i           ( exe_state_q.vl        ),
-        .vl_count_i     ( vl_count_q            ),
-        .vl_update_o    ( mask_vl_update        ),
-        .rd_addr_i      ( exe_state_q.rd_index  ),
-        .done_o         ( mask_done             ),
+        .valid_i             ( mask_valid            ),
+        .vmask_ctrl_i        ( exe_state_q.mode.mask ),
+        .vl_i                ( exe_state_q.vl        ),
+        .vl_count_i          ( vl_count_q            ),
+        .vl_update_o         ( mask_vl_update        ),
+        .vsew_i              ( exe_state_q.eew       ),
+        .rd_addr_i           ( exe_state_q.rd_index  ),
+        .done_o              ( mask_done             ),
 
         // input operand source
-        .rs1_val_i      ( rs1_val_q             ),
-        .rs2_val_i      ( rs2_val_q             ),
+        .rs1_val_i           ( rs1_val_q[VLEN-1:0]   ),
+        .rs2_val_i           ( rs2_val_q[VLEN-1:0]   ),
+        .rs3_val_i           ( rs3_val_q[VLEN-1:0]   ),
+        .vreg_v0_i           ( vreg_v0_i             ),
 
         // output result
-        .result_valid_o ( mask_result_valid     ),
-        .result_addr_o  ( mask_result_addr      ),
-        .result_data_o  ( mask_result_data      ),
-        .result_bweb_o  ( mask_result_bweb      )
+        .result_valid_o      ( mask_result_valid     ),
+        .result_addr_o       ( mask_result_addr      ),
+        .result_data_o       ( mask_result_data      ),
+        .result_bweb_o       ( mask_result_bweb      ),
+
+        // scalar result
+        .xreg_result_valid_o ( mask_xreg_valid       ),
+        .xreg_result_o       ( mask_xreg_result      )
     );
 
+    assign xreg_result_valid_o = mask_xreg_valid;
+    assign xreg_result_o       = mask_xreg_result;
+
     // --------------------------------------------
     //                    VLSU                     
     // --------------------------------------------
@@ -408,12 +501,13 @@ module VPU_execute_stage (
         .vl_count_i       ( vl_count_q           ),
         .vl_update_o      ( lsu_vl_update        ),
         .done_o           ( lsu_done             ),
+        .kill_i           ( exe_kill_i           ),
 
         .base_address_i   ( rs1_val_q[31:0]      ),
-        .address_offset_i ( rs2_val_q            ),
+        .address_offset_i ( rs2_val_q[VLEN-1:0]  ),
         .stride_i         ( rs2_val_q[31:0]      ),
         .mask_i           ( vreg_v0_i            ),
-        .store_data_i     ( rs3_val_q            ),
+        .store_data_i     ( rs3_val_q[2*VLEN-1:0] ),
 
         // output result
         .rd_addr_i        ( exe_state_q.rd_index ),
@@ -427,10 +521,36 @@ module VPU_execute_stage (
         .dcache_vpu_write_o,
         .dcache_vpu_addr_o,
         .dcache_vpu_in_o,
+        .dcache_vpu_inv_o,
+
+        // prefetch hint to D$
+        .dcache_pf_request_o,
+        .dcache_pf_addr_o,
+        .dcache_pf_end_o,
 
         // response from D$
         .dcache_vpu_wait_i,
-        .dcache_vpu_out_i
+        .dcache_vpu_out_i,
+        .dcache_sb_empty_i,
+
+        // non-temporal burst
+        .nt_request_o,
+        .nt_write_o,
+        .nt_addr_o,
+        .nt_len_o,
+        .nt_in_o,
+        .nt_strb_o,
+        .nt_in_ready_i,
+        .nt_wait_i,
+        .nt_out_valid_i,
+        .nt_out_i,
+
+        // vector scratchpad
+        .spm_request_o,
+        .spm_write_o,
+        .spm_addr_o,
+        .spm_in_o,
+        .spm_out_i
     );
 
 
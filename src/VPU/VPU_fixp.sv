@@ -0,0 +1,70 @@
+module VPU_fixp (
+    // request from VALU / VMUL
+    input  VFIXP_REQ_t  fixp_req_i,
+
+    // rounded / saturated result
+    output logic [63:0] result_o,
+    output logic        sat_o
+);
+
+    // --------------------------------------------
+    //              Signal Declaration             
+    // --------------------------------------------
+    logic [129:0] shifted;
+    logic         bit_d;     // v[d]
+    logic         bit_half;  // v[d-1]
+    logic         sticky;    // v[d-2:0] != 0
+    logic         r;         // rounding increment
+    logic [129:0] rounded;
+
+    logic [6:0]   sew_bits;
+    logic [129:0] max_value, min_value;
+
+    // --------------------------------------------
+    //                  Rounding                   
+    // --------------------------------------------
+    // roundoff(v, d) = (v >> d) + r (see spec 12.1)
+    always_comb begin
+        shifted  = $signed(fixp_req_i.value) >>> fixp_req_i.shift;
+        bit_d    = fixp_req_i.value[fixp_req_i.shift];
+        bit_half = (fixp_req_i.shift != 7'd0) ? (fixp_req_i.value[fixp_req_i.shift - 7'd1]) : (1'b0);
+        sticky   = (fixp_req_i.shift >  7'd1) ? ((fixp_req_i.value & ((130'd1 << (fixp_req_i.shift - 7'd1)) - 130'd1)) != 130'd0) : (1'b0);
+        r        = 1'b0;
+
+        unique case (fixp_req_i.vxrm)
+            VXRM_RNU : r = bit_half;
+            VXRM_RNE : r = bit_half & (sticky | bit_d);
+            VXRM_RDN : r = 1'b0;
+            VXRM_ROD : r = ~bit_d & (bit_half | sticky);
+            default  : ; // nothing to do
+        endcase
+
+        rounded = shifted + {129'd0, r};
+    end
+
+    // --------------------------------------------
+    //                 Saturation                  
+    // --------------------------------------------
+    always_comb begin
+        sew_bits  = 7'd8 << fixp_req_i.vsew;
+        max_value = (fixp_req_i.signext) ? ((130'd1 << (sew_bits - 7'd1)) - 130'd1) : ((130'd1 << sew_bits) - 130'd1);
+        min_value = (fixp_req_i.signext) ? (-(130'd1 << (sew_bits - 7'd1)))         : (130'd0);
+
+        sat_o     = 1'b0;
+        result_o  = rounded[63:0];
+
+        if (fixp_req_i.valid && fixp_req_i.clip) begin
+            if ($signed(rounded) > $signed(max_value)) begin
+                sat_o    = 1'b1;
+                result_o = max_value[63:0];
+            end else if ($signed(rounded) < $signed(min_value)) begin
+                sat_o    = 1'b1;
+                result_o = min_value[63:0];
+            end
+        end
+
+        // only keep SEW bits
+        result_o = result_o & ((64'd1 << sew_bits) - 64'd1);
+    end
+
+endmodule
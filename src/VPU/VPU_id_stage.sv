@@ -10,12 +10,19 @@ module VPU_id_stage (
     output logic               vector_ack_o,
     output logic               vector_writeback_o,
     output logic               vector_pend_lsu_o,
+    input  logic               vector_trap_i,
 
     // from VCFG (current vector CSRs)
     input  VSEW_e              vsew_i,    // current SEW (single element width)
     input  VLMUL_e             vlmul_i,   // current register size multiplier
     input  VXRM_e              vxrm_i,    // current rounding mode
     input  logic [VL_BITS-1:0] vl_i,      // current vector length
+    input  logic               vrelax_i,  // vector load / store do not stall CPU
+    input  logic [VL_BITS-2:0] vstart_i,  // first element of the next load / store
+
+    // from / to COMMIT (trap squash)
+    input  logic               kill_pending_i,
+    output logic               rob_squash_o,
 
     // decode buffer --> to CFG or instruction queue
     output logic               decode_entry_valid_o,
@@ -30,6 +37,7 @@ module VPU_id_stage (
     // signal for decoder
     logic     decode_instr_valid;
     VPU_uOP_t decode_instr;
+    logic     is_prefetch;
 
     // decoder buffer
     logic     decode_buffer_ready;
@@ -39,9 +47,13 @@ module VPU_id_stage (
     // --------------------------------------------
     //                Vector Decoder               
     // --------------------------------------------
-    assign vector_ack_o       = decode_instr_valid && decode_buffer_ready;
-    assign vector_writeback_o = decode_instr_valid && ~decode_instr.rd.vreg;
-    assign vector_pend_lsu_o  = decode_instr_valid && (decode_instr.fu == VLSU);
+    // a new instruction waits until the one stopped by a trap has retired and left vstart
+    assign vector_ack_o       = decode_instr_valid && decode_buffer_ready && ~kill_pending_i;
+    assign vector_writeback_o = decode_instr_valid && ~decode_instr.rd.vreg && ~is_prefetch;
+    assign vector_pend_lsu_o  = decode_instr_valid && (decode_instr.fu == VLSU) && ~is_prefetch && ~vrelax_i;
+
+    // prefetch hint has no result, so CPU does not wait for it
+    assign is_prefetch        = (decode_instr.fu == VLSU) && decode_instr.mode.lsu.prefetch;
 
     VPU_decoder i_VPU_decoder (
         .vector_inst_valid_i,
@@ -62,8 +74,19 @@ module VPU_id_stage (
     //                Decode Buffer                
     // --------------------------------------------
     assign decode_buffer_ready  = ~decode_buffer_valid_q || decode_ack_i;
-    assign decode_entry_valid_o = decode_buffer_valid_q;
-    assign decode_entry_o       = decode_buffer_q;
+    assign decode_entry_valid_o = decode_buffer_valid_q && ~vector_trap_i;
+
+    // ----------------------------------------------------------
+    // a trap restarts the youngest vector instruction : it is
+    // dropped here if it is still in the decode buffer, or else
+    // stopped in VIQ / execute stage by the reorder buffer
+    // ----------------------------------------------------------
+    assign rob_squash_o         = vector_trap_i && ~decode_buffer_valid_q;
+
+    always_comb begin
+        decode_entry_o        = decode_buffer_q;
+        decode_entry_o.vstart = VL_BITS'(vstart_i);
+    end
 
     always_ff @(posedge clk_i) begin
         if (rst_i) begin
@@ -84,7 +107,7 @@ module VPU_id_stage (
             decode_buffer_n       = decode_instr;
         end
 
-        if (VCFG_commit_i) begin
+        if (VCFG_commit_i || vector_trap_i) begin
             decode_buffer_valid_n = 1'b0;
         end
     end
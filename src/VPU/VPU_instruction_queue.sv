@@ -6,6 +6,7 @@ module VPU_instruction_queue (
     input  logic     decode_entry_valid_i,
     input  VPU_uOP_t decode_entry_i,
     output logic     decode_accept_o,
+    output logic     viq_empty_o,
 
     // to VPU DISP
     output logic     dispatch_entry_valid_o,
@@ -28,6 +29,7 @@ module VPU_instruction_queue (
     // --------------------------------------------
     assign viq_full               = (viq_size_q == (VIQ_TAG_BITS+1)'(VIQ_DEPTH));
     assign decode_accept_o        = viq_push;
+    assign viq_empty_o            = (viq_size_q == (VIQ_TAG_BITS+1)'(0));
     assign dispatch_entry_valid_o = VIQ[dispatch_ptr_q].valid;
     assign dispatch_entry_o       = VIQ[dispatch_ptr_q].uOP;
 
@@ -14,7 +14,12 @@ module VPU_issue_stage (
     // to EXE
     output logic     dispatch_valid_o,
     output VPU_uOP_t dispatch_entry_o,
-    input  logic     dispatch_ready_i
+    input  logic     dispatch_ready_i,
+    input  logic     exe_idle_i,
+    output logic     viq_empty_o,
+
+    // performance event (decoded instruction waits for a VIQ entry)
+    output logic     viq_stall_o
 );
 
     // --------------------------------------------
@@ -22,6 +27,9 @@ module VPU_issue_stage (
     // --------------------------------------------
     // instruction queue
     logic     decode_accept;
+    logic     viq_empty;
+    logic     vxsat_access;
+    logic     drain;
     
     // to Vector DISP
     logic     dispatch_entry_valid;
@@ -37,11 +45,19 @@ module VPU_issue_stage (
     // the instruction queue entirely. After being decoded, these instructions
     // are directly issued to the execution unit (VCFG) without entering the queue.
     // CSR Instruction include : zicsr and vset[i]vl[i]
+    //
+    // vxsat is updated by the older fixed-point instructions, so an access to
+    // vxsat / vcsr waits until the queue and execute stage are drained.
+    // A vector fence also waits for the drain, then releases the CPU.
     always_comb begin
         VCFG_valid_o = 1'b0;
         VCFG_entry_o = VPU_uOP_t'(0);
+        vxsat_access = decode_entry_i.mode.cfg.csr_op inside {CFG_VXSAT_WRITE, CFG_VXSAT_SET, CFG_VXSAT_CLEAR,
+                                                              CFG_VCSR_WRITE,  CFG_VCSR_SET,  CFG_VCSR_CLEAR};
+
+        drain        = vxsat_access || (decode_entry_i.mode.cfg.csr_op == CFG_VFENCE);
 
-        if (decode_entry_valid_i && decode_entry_i.fu == VCFG) begin
+        if (decode_entry_valid_i && decode_entry_i.fu == VCFG && (~drain || (viq_empty && exe_idle_i))) begin
             VCFG_valid_o = 1'b1;
             VCFG_entry_o = decode_entry_i;
         end
@@ -51,6 +67,8 @@ module VPU_issue_stage (
     //            VPU instruction queue            
     // --------------------------------------------
     assign decode_ack_o = decode_accept;
+    assign viq_empty_o  = viq_empty;
+    assign viq_stall_o  = decode_entry_valid_i && decode_entry_i.fu != VCFG && ~decode_accept;
 
     VPU_instruction_queue i_VPU_instruction_queue (
         .clk_i,
@@ -59,6 +77,7 @@ module VPU_issue_stage (
         .decode_entry_valid_i,
         .decode_entry_i,
         .decode_accept_o        ( decode_accept        ),
+        .viq_empty_o            ( viq_empty            ),
 
         .dispatch_entry_valid_o ( dispatch_entry_valid ),
         .dispatch_entry_o       ( dispatch_entry       ),
@@ -18,7 +18,8 @@ module VPU_lane (
     // result
     output logic            result_valid_o,
     output logic            result_en_o,
-    output logic [63:0]     result_o
+    output logic [63:0]     result_o,
+    output logic            result_sat_o
 );
 
     // --------------------------------------------
@@ -28,6 +29,14 @@ module VPU_lane (
     logic        vmul_valid, vmul_result_valid, vmul_result_en;
     logic [63:0] valu_result, vmul_result;
 
+    // operand isolation (operands of an unused unit are held at zero)
+    logic [63:0] valu_operand1, valu_operand2;
+    logic [63:0] vmul_operand1, vmul_operand2, vmul_operand3;
+
+    VFIXP_REQ_t  valu_fixp, vmul_fixp, fixp_req;
+    logic [63:0] fixp_result;
+    logic        fixp_sat;
+
     // --------------------------------------------
     //                  Result Mux                 
     // --------------------------------------------
@@ -51,46 +60,78 @@ module VPU_lane (
 
             default : ; // nothing to do
         endcase
+
+        // fixed-point rounding / saturation overrides the raw result
+        if (fixp_req.valid) begin
+            result_o = fixp_result;
+        end
+
+        result_sat_o = fixp_req.valid && fixp_sat;
     end
 
     // --------------------------------------------
     //          VALU (finish in one cycle)         
     // --------------------------------------------
-    assign valu_valid = (valid_i && fu_i == VALU);
+    assign valu_valid    = (valid_i && fu_i == VALU);
+    assign valu_operand1 = (valu_valid) ? (operand1_i) : (64'd0);
+    assign valu_operand2 = (valu_valid) ? (operand2_i) : (64'd0);
     
     VPU_alu i_VPU_alu (
         .valid_i        ( valu_valid        ),
         .valu_ctrl_i    ( mode_i.alu        ),
         .vsew_i,
         .vxrm_i,
-        .operand1_i,
-        .operand2_i,
+        .operand1_i     ( valu_operand1     ),
+        .operand2_i     ( valu_operand2     ),
         .mask_i,
         .result_valid_o ( valu_result_valid ),
         .result_en_o    ( valu_result_en    ),
-        .result_o       ( valu_result       )
+        .result_o       ( valu_result       ),
+        .fixp_o         ( valu_fixp         )
     );
 
     // --------------------------------------------
     //          VMUL (finish in two cycle)         
     // --------------------------------------------
-    assign mul_valid = (valid_i && fu_i == VMUL);
+    assign vmul_valid    = (valid_i && fu_i == VMUL);
+    assign vmul_operand1 = (vmul_valid) ? (operand1_i) : (64'd0);
+    assign vmul_operand2 = (vmul_valid) ? (operand2_i) : (64'd0);
+    assign vmul_operand3 = (vmul_valid) ? (operand3_i) : (64'd0);
     
     VPU_mul i_VPU_mul (
         .clk_i,
         .rst_i,
-        .valid_i        ( mul_valid         ),
+        .valid_i        ( vmul_valid        ),
         .vmul_ctrl_i    ( mode_i.mul        ),
         .vsew_i,
         .vxrm_i,
-        .operand1_i,
-        .operand2_i,
-        .operand3_i,
+        .operand1_i     ( vmul_operand1     ),
+        .operand2_i     ( vmul_operand2     ),
+        .operand3_i     ( vmul_operand3     ),
         .mask_i,
         .result_valid_o ( vmul_result_valid ),
         .result_en_o    ( vmul_result_en    ),
-        .result_o       ( vmul_result       )
+        .result_o       ( vmul_result       ),
+        .fixp_o         ( vmul_fixp         )
     );
 
+    // --------------------------------------------
+    //       Fixed-Point Rounding / Saturation     
+    // --------------------------------------------
+    always_comb begin
+        fixp_req = VFIXP_REQ_t'(0);
+
+        unique case (fu_i)
+            VALU    : fixp_req = valu_fixp;
+            VMUL    : fixp_req = vmul_fixp;
+            default : ; // nothing to do
+        endcase
+    end
+
+    VPU_fixp i_VPU_fixp (
+        .fixp_req_i     ( fixp_req          ),
+        .result_o       ( fixp_result       ),
+        .sat_o          ( fixp_sat          )
+    );
 
 endmodule
\ No newline at end of file
@@ -12,20 +12,24 @@ module VPU_lane_wrapper (
     input  VSEW_e              vsew_i,
     input  VXRM_e              vxrm_i,
     input  logic [4:0]         rd_addr_i,
+    input  logic               narrow_i,
     output logic               done_o,
 
-    // input operand source
-    input  logic [2:0]         use_vreg_i,
-    input  logic [VLEN-1:0]    rs1_val_i,
-    input  logic [VLEN-1:0]    rs2_val_i,
-    input  logic [VLEN-1:0]    rs3_val_i,
-    input  logic [VLEN-1:0]    vreg_v0_i,
-
-    // output result
-    output logic               result_valid_o,
-    output logic [4:0]         result_addr_o,
-    output logic [VLEN/8-1:0]  result_bweb_o,
-    output logic [VLEN-1:0]    result_data_o
+    // input operand source (VREG_SLICES consecutive vregs)
+    input  logic [2:0]            use_vreg_i,
+    input  logic [VGRP_LEN-1:0]   rs1_val_i,
+    input  logic [VGRP_LEN-1:0]   rs2_val_i,
+    input  logic [VGRP_LEN-1:0]   rs3_val_i,
+    input  logic [VLEN-1:0]       vreg_v0_i,
+
+    // output result (VREG_SLICES consecutive vregs starting at result_addr_o)
+    output logic                  result_valid_o,
+    output logic [4:0]            result_addr_o,
+    output logic [VGRP_LEN/8-1:0] result_bweb_o,
+    output logic [VGRP_LEN-1:0]   result_data_o,
+
+    // fixed-point saturation happened (vxsat)
+    output logic               vxsat_o
 );
 
     // --------------------------------------------
@@ -40,6 +44,7 @@ module VPU_lane_wrapper (
         logic        result_valid; // the result is valid right now
         logic        result_en;    // if we need to writeback the result
         logic [63:0] result;       // execution result of each lane
+        logic        result_sat;   // fixed-point result is saturated
     } lane_info_t;
 
     // lane installation
@@ -48,10 +53,23 @@ module VPU_lane_wrapper (
     logic       result_mask;       // if the result is a mask
     logic [4:0] rd_offset, rd_offset_q;
 
+    // ---------------------------------------------------------
+    // element-wise results use all 8 lanes at every SEW, the
+    // operands of one step span (8 >> (3 - vsew)) vreg slices;
+    // mask results and narrowing stay inside a single slice
+    // ---------------------------------------------------------
+    logic [3:0] lane_num;          // lanes used by one step
+
+    // narrowing : 2*SEW source uses a whole slice for half of the lanes
+    logic [VL_BITS-1:0] narrow_pos;   // element position of this step inside the vd / vs1 slice
+
     // --------------------------------------------
     //              Lane operand select            
     // --------------------------------------------
-    assign done_o = valid_i && (vl_count_i == vl_i) && ~(lane_info[0].result_valid);
+    assign done_o      = valid_i && (vl_count_i == vl_i) && ~(lane_info[0].result_valid);
+    assign result_mask = fu_i == VALU && mode_i.alu.mask_res;
+    assign lane_num    = (narrow_i)    ? (4'd4 >> vsew_i) :
+                         (result_mask) ? (4'd8 >> vsew_i) : (4'd8);
 
     always_comb begin
         // default values: all lanes are disabled and operands are zeroed
@@ -64,7 +82,52 @@ module VPU_lane_wrapper (
             vd_mask  [i]          = 1'b0;
         end
 
-        if (valid_i) begin
+        // narrowing step begins at the middle of the slice every other cycle
+        narrow_pos = vl_count_i & ((VL_BITS'(8) >> vsew_i) - VL_BITS'(1));
+
+        if (valid_i && narrow_i) begin
+            // vs2 holds 2*SEW elements, vs1 / vd hold SEW elements
+            case (vsew_i)
+                VSEW_8 : begin
+                    for (int i = 0; i < 4; i++) begin
+                        lane_info[i].valid    = (i + {(32-VL_BITS)'(0), vl_count_i} < {(32-VL_BITS)'(0), vl_i});
+                        lane_info[i].operand1 = {56'd0, rs1_val_i[(i + narrow_pos)*8 +: 8]};
+                        lane_info[i].operand2 = {48'd0, rs2_val_i[i*16 +: 16]};
+                        lane_info[i].operand3 = {56'd0, rs3_val_i[(i + narrow_pos)*8 +: 8]};
+                        lane_info[i].mask     = vreg_v0_i[i + {(32-VL_BITS)'(0), vl_count_i}];
+                    end
+                end
+
+                VSEW_16 : begin
+                    for (int i = 0; i < 2; i++) begin
+                        lane_info[i].valid    = (i + {(32-VL_BITS)'(0), vl_count_i} < {(32-VL_BITS)'(0), vl_i});
+                        lane_info[i].operand1 = {48'd0, rs1_val_i[(i + narrow_pos)*16 +: 16]};
+                        lane_info[i].operand2 = {32'd0, rs2_val_i[i*32 +: 32]};
+                        lane_info[i].operand3 = {48'd0, rs3_val_i[(i + narrow_pos)*16 +: 16]};
+                        lane_info[i].mask     = vreg_v0_i[i + {(32-VL_BITS)'(0), vl_count_i}];
+                    end
+                end
+
+                VSEW_32 : begin
+                    for (int i = 0; i < 1; i++) begin
+                        lane_info[i].valid    = (i + {(32-VL_BITS)'(0), vl_count_i} < {(32-VL_BITS)'(0), vl_i});
+                        lane_info[i].operand1 = {32'd0, rs1_val_i[(i + narrow_pos)*32 +: 32]};
+                        lane_info[i].operand2 = rs2_val_i[63:0];
+                        lane_info[i].operand3 = {32'd0, rs3_val_i[(i + narrow_pos)*32 +: 32]};
+                        lane_info[i].mask     = vreg_v0_i[i + {(32-VL_BITS)'(0), vl_count_i}];
+                    end
+                end
+
+                default : ; // nothing to do (no narrowing to SEW = 64)
+            endcase
+
+            // shift amount from scalar / immediate
+            for (int i = 0; i < 8; i++) begin
+                if (lane_info[i].valid && use_vreg_i[0] != 1'b1) begin
+                    lane_info[i].operand1 = rs1_val_i[63:0];
+                end
+            end
+        end else if (valid_i) begin
             // assign values based on sew and vl
             case (vsew_i)
                 // for sew = 8, enable all lanes and assign 8-bit operands
@@ -79,39 +142,45 @@ module VPU_lane_wrapper (
                     end
                 end
 
-                // for sew = 16, enable up to 4 lanes and assign 16-bit operands
+                // for sew = 16, enable up to 8 lanes (2 slices) and assign 16-bit operands
                 VSEW_16 : begin
-                    for (int i = 0; i < 4; i++) begin
-                        lane_info[i].valid    = (i + {(32-VL_BITS)'(0), vl_count_i} < {(32-VL_BITS)'(0), vl_i});   // enable lanes within vl
-                        lane_info[i].operand1 = {48'd0, rs1_val_i[i*16 +: 16]};     // extract 16-bit rs1
-                        lane_info[i].operand2 = {48'd0, rs2_val_i[i*16 +: 16]};     // extract 16-bit rs2
-                        lane_info[i].operand3 = {48'd0, rs3_val_i[i*16 +: 16]};     // extract 16-bit rs3
-                        lane_info[i].mask     = vreg_v0_i[i + {(32-VL_BITS)'(0), vl_count_i}]; // extract mask v0[3:0]
-                        vd_mask  [i]          = rs3_val_i[i + {(32-VL_BITS)'(0), vl_count_i}]; // the mask value in rd
+                    for (int i = 0; i < 8; i++) begin
+                        if (i < lane_num) begin
+                            lane_info[i].valid    = (i + {(32-VL_BITS)'(0), vl_count_i} < {(32-VL_BITS)'(0), vl_i});   // enable lanes within vl
+                            lane_info[i].operand1 = {48'd0, rs1_val_i[i*16 +: 16]};     // extract 16-bit rs1
+                            lane_info[i].operand2 = {48'd0, rs2_val_i[i*16 +: 16]};     // extract 16-bit rs2
+                            lane_info[i].operand3 = {48'd0, rs3_val_i[i*16 +: 16]};     // extract 16-bit rs3
+                            lane_info[i].mask     = vreg_v0_i[i + {(32-VL_BITS)'(0), vl_count_i}]; // extract mask v0
+                            vd_mask  [i]          = rs3_val_i[i + {(32-VL_BITS)'(0), vl_count_i}]; // the mask value in rd
+                        end
                     end
                 end
 
-                // for sew = 32, enable up to 2 lanes and assign 32-bit operands
+                // for sew = 32, enable up to 8 lanes (4 slices) and assign 32-bit operands
                 VSEW_32 : begin
-                    for (int i = 0; i < 2; i++) begin
-                        lane_info[i].valid    = (i + {(32-VL_BITS)'(0), vl_count_i} < {(32-VL_BITS)'(0), vl_i});   // enable lanes within vl
-                        lane_info[i].operand1 = {32'd0, rs1_val_i[i*32 +: 32]};     // extract 32-bit rs1
-                        lane_info[i].operand2 = {32'd0, rs2_val_i[i*32 +: 32]};     // extract 32-bit rs2
-                        lane_info[i].operand3 = {32'd0, rs3_val_i[i*32 +: 32]};     // extract 32-bit rs3
-                        lane_info[i].mask     = vreg_v0_i[i + {(32-VL_BITS)'(0), vl_count_i}]; // extract mask v0[1:0]
-                        vd_mask  [i]          = rs3_val_i[i + {(32-VL_BITS)'(0), vl_count_i}]; // the mask value in rd
+                    for (int i = 0; i < 8; i++) begin
+                        if (i < lane_num) begin
+                            lane_info[i].valid    = (i + {(32-VL_BITS)'(0), vl_count_i} < {(32-VL_BITS)'(0), vl_i});   // enable lanes within vl
+                            lane_info[i].operand1 = {32'd0, rs1_val_i[i*32 +: 32]};     // extract 32-bit rs1
+                            lane_info[i].operand2 = {32'd0, rs2_val_i[i*32 +: 32]};     // extract 32-bit rs2
+                            lane_info[i].operand3 = {32'd0, rs3_val_i[i*32 +: 32]};     // extract 32-bit rs3
+                            lane_info[i].mask     = vreg_v0_i[i + {(32-VL_BITS)'(0), vl_count_i}]; // extract mask v0
+                            vd_mask  [i]          = rs3_val_i[i + {(32-VL_BITS)'(0), vl_count_i}]; // the mask value in rd
+                        end
                     end
                 end
 
-                // for sew = 64, only the first lane is enabled and assigned 64-bit operands
+                // for sew = 64, enable up to 8 lanes (8 slices) and assign 64-bit operands
                 VSEW_64 : begin
-                    for (int i = 0; i < 1; i++) begin
-                        lane_info[i].valid    = (i + {(32-VL_BITS)'(0), vl_count_i} < {(32-VL_BITS)'(0), vl_i});   // enable the first lane if vl > 0
-                        lane_info[i].operand1 = rs1_val_i[i*64 +: 64];     // extract 64-bit rs1
-                        lane_info[i].operand2 = rs2_val_i[i*64 +: 64];     // extract 64-bit rs2
-                        lane_info[i].operand3 = rs3_val_i[i*64 +: 64];     // extract 64-bit rs2
-                        lane_info[i].mask     = vreg_v0_i[i + {(32-VL_BITS)'(0), vl_count_i}]; // extract mask v0[0]
-                        vd_mask  [i]          = rs3_val_i[i + {(32-VL_BITS)'(0), vl_count_i}]; // the mask value in rd
+                    for (int i = 0; i < 8; i++) begin
+                        if (i < lane_num) begin
+                            lane_info[i].valid    = (i + {(32-VL_BITS)'(0), vl_count_i} < {(32-VL_BITS)'(0), vl_i});   // enable lanes within vl
+                            lane_info[i].operand1 = rs1_val_i[i*64 +: 64];     // extract 64-bit rs1
+                            lane_info[i].operand2 = rs2_val_i[i*64 +: 64];     // extract 64-bit rs2
+                            lane_info[i].operand3 = rs3_val_i[i*64 +: 64];     // extract 64-bit rs3
+                            lane_info[i].mask     = vreg_v0_i[i + {(32-VL_BITS)'(0), vl_count_i}]; // extract mask v0
+                            vd_mask  [i]          = rs3_val_i[i + {(32-VL_BITS)'(0), vl_count_i}]; // the mask value in rd
+                        end
                     end
                 end
 
@@ -122,11 +191,11 @@ module VPU_lane_wrapper (
             // --> all lane should be same value
             for (int i = 0; i < 8; i++) begin
                 if (lane_info[i].valid && use_vreg_i[0] != 1'b1) begin
-                    lane_info[i].operand1 = rs1_val_i;
+                    lane_info[i].operand1 = rs1_val_i[63:0];
                 end
 
                 if (lane_info[i].valid && use_vreg_i[1] != 1'b1) begin
-                    lane_info[i].operand2 = rs2_val_i;
+                    lane_info[i].operand2 = rs2_val_i[63:0];
                 end
             end
         end
@@ -153,7 +222,8 @@ module VPU_lane_wrapper (
 
                 .result_valid_o ( lane_info[i].result_valid ),
                 .result_en_o    ( lane_info[i].result_en    ),
-                .result_o       ( lane_info[i].result       )
+                .result_o       ( lane_info[i].result       ),
+                .result_sat_o   ( lane_info[i].result_sat   )
             );
         end
     endgenerate
@@ -179,66 +249,98 @@ module VPU_lane_wrapper (
 
         result_valid_o = lane_info[0].result_valid;
         result_addr_o  = rd_addr_i + rd_offset;
-        result_bweb_o  = (VLEN/8)'(0);
-        result_data_o  = VLEN'(0);
-        vl_update_o    = VL_BITS'(8) >> vsew_i;
-        result_mask    = fu_i == VALU && mode_i.alu.mask_res;
+        result_bweb_o  = (VGRP_LEN/8)'(0);
+        result_data_o  = VGRP_LEN'(0);
+        vl_update_o    = VL_BITS'(lane_num);
+        vxsat_o        = 1'b0;
+
+        for (int i = 0; i < 8; i++) begin
+            if (lane_info[i].result_valid && lane_info[i].result_en && lane_info[i].result_sat) begin
+                vxsat_o = 1'b1;
+            end
+        end
 
         if (fu_i == VMUL) begin
             result_addr_o = rd_addr_i + rd_offset_q;
         end
 
-        unique case (vsew_i)
-            VSEW_8 : begin
-                for (int i = 0; i < 8; i++) begin
-                    if (result_mask) begin
-                        result_data_o[i + {(32-VL_BITS)'(0), vl_count_i}] = (lane_info[i].result_valid) ? (vd_mask[i + {(32-VL_BITS)'(0), vl_count_i}]) : (lane_info[i].result[0]);
-                        result_bweb_o = 8'd1 << (vl_count_i >> 3); // move to left when 
-                    end else if (lane_info[i].result_valid && lane_info[i].result_en) begin
-                        result_data_o[i*8 +: 8] = lane_info[i].result[7:0];
-                        result_bweb_o[i]        = 1'b1;
-                    end
+        if (narrow_i) begin
+            // write back SEW results to their position inside the vd slice
+            for (int i = 0; i < 4; i++) begin
+                if (lane_info[i].result_valid && lane_info[i].result_en) begin
+                    unique case (vsew_i)
+                        VSEW_8  : begin
+                            result_data_o[(i + narrow_pos)*8  +:  8] = lane_info[i].result[7:0];
+                            result_bweb_o[(i + narrow_pos)         ] = 1'b1;
+                        end
+
+                        VSEW_16 : begin
+                            result_data_o[(i + narrow_pos)*16 +: 16] = lane_info[i].result[15:0];
+                            result_bweb_o[(i + narrow_pos)*2  +:  2] = 2'b11;
+                        end
+
+                        VSEW_32 : begin
+                            result_data_o[(i + narrow_pos)*32 +: 32] = lane_info[i].result[31:0];
+                            result_bweb_o[(i + narrow_pos)*4  +:  4] = 4'b1111;
+                        end
+
+                        default : ; // nothing to do
+                    endcase
                 end
             end
+        end else begin
+            unique case (vsew_i)
+                VSEW_8 : begin
+                    for (int i = 0; i < 8; i++) begin
+                        if (result_mask) begin
+                            result_data_o[i + {(32-VL_BITS)'(0), vl_count_i}] = (lane_info[i].result_valid) ? (vd_mask[i + {(32-VL_BITS)'(0), vl_count_i}]) : (lane_info[i].result[0]);
+                            result_bweb_o = 8'd1 << (vl_count_i >> 3); // move to left when 
+                        end else if (lane_info[i].result_valid && lane_info[i].result_en) begin
+                            result_data_o[i*8 +: 8] = lane_info[i].result[7:0];
+                            result_bweb_o[i]        = 1'b1;
+                        end
+                    end
+                end
 
-            VSEW_16 : begin
-                for (int i = 0; i < 4; i++) begin
-                    if (result_mask) begin
-                        result_data_o[i + {(32-VL_BITS)'(0), vl_count_i}] = (lane_info[i].result_valid) ? (vd_mask[i + {(32-VL_BITS)'(0), vl_count_i}]) : (lane_info[i].result[0]);
-                        result_bweb_o = 8'd1 << (vl_count_i >> 3);
-                    end else if (lane_info[i].result_valid && lane_info[i].result_en) begin
-                        result_data_o[i*16 +: 16] = lane_info[i].result[15:0];
-                        result_bweb_o[i*2  +:  2] = 2'b11;
+                VSEW_16 : begin
+                    for (int i = 0; i < 8; i++) begin
+                        if (result_mask && i < lane_num) begin
+                            result_data_o[i + {(32-VL_BITS)'(0), vl_count_i}] = (lane_info[i].result_valid) ? (vd_mask[i + {(32-VL_BITS)'(0), vl_count_i}]) : (lane_info[i].result[0]);
+                            result_bweb_o = 8'd1 << (vl_count_i >> 3);
+                        end else if (lane_info[i].result_valid && lane_info[i].result_en) begin
+                            result_data_o[i*16 +: 16] = lane_info[i].result[15:0];
+                            result_bweb_o[i*2  +:  2] = 2'b11;
+                        end
                     end
                 end
-            end
 
-            VSEW_32 : begin
-                for (int i = 0; i < 2; i++) begin
-                    if (result_mask) begin
-                        result_data_o[i + {(32-VL_BITS)'(0), vl_count_i}] = (lane_info[i].result_valid) ? (vd_mask[i + {(32-VL_BITS)'(0), vl_count_i}]) : (lane_info[i].result[0]);
-                        result_bweb_o = 8'd1 << (vl_count_i >> 3);
-                    end else if (lane_info[i].result_valid && lane_info[i].result_en) begin
-                        result_data_o[i*32 +: 32] = lane_info[i].result[31:0];
-                        result_bweb_o[i*4  +:  4] = 4'b1111;
+                VSEW_32 : begin
+                    for (int i = 0; i < 8; i++) begin
+                        if (result_mask && i < lane_num) begin
+                            result_data_o[i + {(32-VL_BITS)'(0), vl_count_i}] = (lane_info[i].result_valid) ? (vd_mask[i + {(32-VL_BITS)'(0), vl_count_i}]) : (lane_info[i].result[0]);
+                            result_bweb_o = 8'd1 << (vl_count_i >> 3);
+                        end else if (lane_info[i].result_valid && lane_info[i].result_en) begin
+                            result_data_o[i*32 +: 32] = lane_info[i].result[31:0];
+                            result_bweb_o[i*4  +:  4] = 4'b1111;
+                        end
                     end
                 end
-            end
 
-            VSEW_64 : begin
-                for (int i = 0; i < 1; i++) begin
-                    if (result_mask) begin
-                        result_data_o[i + {(32-VL_BITS)'(0), vl_count_i}] = (lane_info[i].result_valid) ? (vd_mask[i + {(32-VL_BITS)'(0), vl_count_i}]) : (lane_info[i].result[0]);
-                        result_bweb_o = 8'd1 << (vl_count_i >> 3);
-                    end else if (lane_info[i].result_valid && lane_info[i].result_en) begin
-                        result_data_o[i*64 +: 64] = lane_info[i].result[63:0];
-                        result_bweb_o[i*8  +:  8] = 8'b11111111;
+                VSEW_64 : begin
+                    for (int i = 0; i < 8; i++) begin
+                        if (result_mask && i < lane_num) begin
+                            result_data_o[i + {(32-VL_BITS)'(0), vl_count_i}] = (lane_info[i].result_valid) ? (vd_mask[i + {(32-VL_BITS)'(0), vl_count_i}]) : (lane_info[i].result[0]);
+                            result_bweb_o = 8'd1 << (vl_count_i >> 3);
+                        end else if (lane_info[i].result_valid && lane_info[i].result_en) begin
+                            result_data_o[i*64 +: 64] = lane_info[i].result[63:0];
+                            result_bweb_o[i*8  +:  8] = 8'b11111111;
+                        end
                     end
                 end
-            end
 
-            default : ; // nothing to do
-        endcase
+                default : ; // nothing to do
+            endcase
+        end
     end
 
-endmodule
\ No newline at end of file
+endmodule
@@ -9,60 +9,127 @@ module VPU_lsu (
     input  logic [VL_BITS-1:0] vl_count_i,
     output logic [VL_BITS-1:0] vl_update_o,
     output logic               done_o,
+    input  logic               kill_i,        // stopped by a trap, finish at the next element
 
     // input source
     input  logic [31:0]        base_address_i,
     input  logic [63:0]        address_offset_i,
     input  logic [31:0]        stride_i,
     input  logic [VLEN-1:0]    mask_i,
-    input  logic [63:0]        store_data_i,
+    input  logic [2*VLEN-1:0]  store_data_i,  // the slice of vl_count and the next one
 
-    // output result (register writeback)
+    // output result (register writeback, two slices starting at result_addr_o)
     input  logic [4:0]         rd_addr_i,
     output logic               result_valid_o,
     output logic [4:0]         result_addr_o,
-    output logic [VLEN/8-1:0]  result_bweb_o,
-    output logic [VLEN-1:0]    result_data_o,
+    output logic [VLEN/4-1:0]  result_bweb_o,
+    output logic [2*VLEN-1:0]  result_data_o,
 
     // request to D$
     output logic               dcache_vpu_request_o,
     output logic [ 3:0]        dcache_vpu_write_o,
     output logic [31:0]        dcache_vpu_addr_o,
     output logic [31:0]        dcache_vpu_in_o,
+    output logic               dcache_vpu_inv_o,
+
+    // prefetch hint to D$ (no response)
+    output logic               dcache_pf_request_o,
+    output logic [31:0]        dcache_pf_addr_o,
+    output logic [31:0]        dcache_pf_end_o,
 
     // response from D$
     input  logic               dcache_vpu_wait_i,
-    input  logic [31:0]        dcache_vpu_out_i
-
+    input  logic [31:0]        dcache_vpu_out_i,
+    input  logic               dcache_sb_empty_i, // buffered D$ stores are in memory
+
+    // non-temporal burst (bypass D$)
+    output logic               nt_request_o,
+    output logic               nt_write_o,
+    output logic [31:0]        nt_addr_o,
+    output logic [ 3:0]        nt_len_o,
+    output logic [31:0]        nt_in_o,
+    output logic [ 3:0]        nt_strb_o,
+    input  logic               nt_in_ready_i,
+    input  logic               nt_wait_i,
+    input  logic               nt_out_valid_i,
+    input  logic [31:0]        nt_out_i,
+
+    // vector scratchpad (bypass D$ and AXI)
+    output logic               spm_request_o,
+    output logic [ 7:0]        spm_write_o,
+    output logic [31:0]        spm_addr_o,
+    output logic [63:0]        spm_in_o,
+    input  logic [63:0]        spm_out_i
 );
     // --------------------------------------------
     //              Signal Declaration             
     // --------------------------------------------
-    typedef enum logic [1:0] {
-        IDLE, READ, WRITE
+    typedef enum logic [2:0] {
+        IDLE, READ, WRITE,
+        NT_READ, NT_WRITE, NT_INV, // non-temporal burst and D$ invalidate
+        SPM_READ, SPM_WRITE        // vector scratchpad, one slice per cycle
     } lsu_state_t;
 
     typedef struct packed {
         logic        valid;
         logic [31:0] addr;
         logic [31:0] vl_count_byte;
+        logic [31:0] end_addr;      // last D$ line touched by a non-temporal store
     } request_buffer_t;
 
     logic [31:0]       vl_byte, vl_count, vl_byte_left;
     lsu_state_t        lsu_state_q, lsu_state_n;
     request_buffer_t   request_buffer_q, request_buffer_n;
     
+    // -----------------------------------------------------------
+    // unaligned unit-stride : every D$ request is word-aligned
+    // except the first one, a word is realigned through a two
+    // slice window (vd slice pair for loads, vs3 pair for stores)
+    // -----------------------------------------------------------
+    logic [31:0]       byte_count;  // bytes already moved
+    logic [31:0]       unit_addr;   // address of the next byte to move
+    logic [31:0]       unit_bytes;  // bytes moved by a unit-stride word
+
+    // -----------------------------------------------------------
+    // restart after a trap : a new request starts at vl_count_i
+    // (vstart), the elements before it are neither read nor
+    // written. A D$ access stopped by kill_i finishes at the next
+    // word and leaves the elements done in vl_update_o; a burst
+    // or scratchpad access is short and always runs to the end
+    // -----------------------------------------------------------
+    logic [31:0]       start_byte;  // bytes before the first element to move
+    logic [31:0]       start_addr;  // address of the first element to move
+
+    // masked access : bytes of inactive elements are neither requested nor written,
+    // a word whose elements are all inactive is skipped without a D$ request
+    logic [3:0]        cur_active;  // active bytes of the word at byte_count
+    logic [31:0]       next_count;  // byte_count of the next load request
+    logic [31:0]       next_bytes;  // bytes checked for the next load request
+    logic              next_active; // the next load request has an active element
+
     // store signal
     logic [31:0]       store_data, align_data;
     logic [3:0]        store_bweb, store_mask;
     logic [31:0]       store_bytes, store_addr_offset;
 
     // load signal
-    logic [63:0]       load_data;
-    logic [VLEN/8-1:0] load_bweb, load_mask;
+    logic [2*VLEN-1:0] load_data;
+    logic [VLEN/4-1:0] load_bweb, load_mask;
     logic [31:0]       load_bytes, load_addr_offset;
     logic [31:0]       element_byte;
     logic [31:0]       data_offset;
+    logic [31:0]       mem_out;
+
+    // non-temporal signal (the stale D$ lines are invalidated one line per request)
+    localparam logic [31:0] LINE_STEP = 32'(DCACHE_LINE_BYTES);
+    localparam logic [31:0] LINE_MASK = ~(LINE_STEP - 32'd1);
+
+    logic              nt_access;
+
+    // scratchpad signal
+    logic              spm_access;
+    logic [31:0]       spm_bytes;
+    logic [7:0]        spm_mask;
 
     // --------------------------------------------
     //                   Control                   
@@ -90,26 +157,85 @@ module VPU_lsu (
         dcache_vpu_addr_o    = 32'd0;
         dcache_vpu_write_o   = 4'b0000;
         dcache_vpu_in_o      = 32'd0;
+        dcache_vpu_inv_o     = 1'b0;
+
+        // default prefetch hint
+        dcache_pf_request_o  = 1'b0;
+        dcache_pf_addr_o     = base_address_i;
+        dcache_pf_end_o      = base_address_i + vl_byte - 32'd1;
+
+        // default non-temporal request
+        nt_request_o = 1'b0;
+        nt_write_o   = mode_i.store;
+        nt_addr_o    = base_address_i;
+        nt_len_o     = 4'(((vl_byte + 32'd3) >> 2) - 32'd1); // beats - 1
+        nt_in_o      = align_data;
+        nt_strb_o    = store_bweb;
+
+        // default scratchpad request
+        spm_request_o = 1'b0;
+        spm_write_o   = 8'd0;
+        spm_addr_o    = request_buffer_q.addr;
+        spm_in_o      = store_data_i[VLEN-1:0];
 
         // default vreg writebakc
         result_valid_o = 1'b0;
         result_addr_o  = 5'd0;
-        result_bweb_o  = (VLEN/8)'(0);
-        result_data_o  = (VLEN)'(0);
+        result_bweb_o  = (VLEN/4)'(0);
+        result_data_o  = (2*VLEN)'(0);
 
         unique case (lsu_state_q)
             // receive new request
             IDLE : begin
-                if (valid_i) begin
+                vl_update_o = vl_count_i;
+
+                if (valid_i && mode_i.prefetch) begin
+                    // hand the range to D$ and finish right away, D$ fills the lines in the background
+                    dcache_pf_request_o = (vl_byte != 32'd0);
+                    vl_update_o         = vl_i;
+                    done_o              = 1'b1;
+
+                end else if (valid_i && (kill_i || start_byte >= vl_byte)) begin
+                    // stopped before it started, or nothing left after vstart
+                    done_o = 1'b1;
+
+                end else if (valid_i && spm_access) begin
+                    // the first slice is sent right now, the data comes back in the next cycle
+                    spm_request_o                  = 1'b1;
+                    spm_addr_o                     = base_address_i;
                     request_buffer_n.valid         = 1'b1;
-                    request_buffer_n.addr          = base_address_i;
+                    request_buffer_n.addr          = base_address_i + 32'd8;
                     request_buffer_n.vl_count_byte = 32'd0;
+                    lsu_state_n                    = (mode_i.store) ? (SPM_WRITE) : (SPM_READ);
+
+                    if (mode_i.store) begin
+                        spm_write_o                    = spm_mask;
+                        request_buffer_n.vl_count_byte = spm_bytes;
+                        vl_update_o                    = request_buffer_n.vl_count_byte >> mode_i.eew;
+                    end
+
+                end else if (valid_i && nt_access) begin
+                    // the whole access is one burst on the non-temporal master,
+                    // it bypasses D$, so wait until the buffered D$ stores are in memory
+                    if (dcache_sb_empty_i) begin
+                        nt_request_o                   = 1'b1;
+                        request_buffer_n.valid         = 1'b1;
+                        request_buffer_n.addr          = base_address_i & LINE_MASK;
+                        request_buffer_n.vl_count_byte = 32'd0;
+                        request_buffer_n.end_addr      = (base_address_i + vl_byte - 32'd1) & LINE_MASK;
+                        lsu_state_n                    = (mode_i.store) ? (NT_WRITE) : (NT_READ);
+                    end
+
+                end else if (valid_i) begin
+                    request_buffer_n.valid         = 1'b1;
+                    request_buffer_n.addr          = start_addr;
+                    request_buffer_n.vl_count_byte = start_byte;
                     lsu_state_n                    = (mode_i.store) ? (WRITE) : (READ);
 
                     if (mode_i.store) begin
-                        // send out request to D$
-                        dcache_vpu_request_o = 1'b1;
-                        dcache_vpu_addr_o    = base_address_i;
+                        // send out request to D$ (not for a word without active elements)
+                        dcache_vpu_request_o = (|store_bweb);
+                        dcache_vpu_addr_o    = start_addr;
                         dcache_vpu_write_o   = store_bweb;
                         dcache_vpu_in_o      = align_data;
 
@@ -118,25 +244,27 @@ module VPU_lsu (
                         // so we need to seperate to 2 store
                         // when 2 store finish(8 bytes is stored), then we can update next base address
                         if (mode_i.stride == VLSU_STRIDED && mode_i.eew == VSEW_64) begin
-                            request_buffer_n.addr = base_address_i;
+                            request_buffer_n.addr = start_addr;
                         end else begin
-                            request_buffer_n.addr = base_address_i + store_addr_offset;
+                            request_buffer_n.addr = start_addr + store_addr_offset;
                         end
 
                         // update request buffer
-                        request_buffer_n.vl_count_byte = store_bytes;
+                        request_buffer_n.vl_count_byte = start_byte + store_bytes;
                         vl_update_o                    = request_buffer_n.vl_count_byte >> mode_i.eew;
 
                     end else begin
-                        // send out request to D$
-                        dcache_vpu_request_o = 1'b1;
-                        dcache_vpu_addr_o    = base_address_i;
+                        // send out request to D$ (not for a word without active elements)
+                        dcache_vpu_request_o = (|(load_mask[3:0] & cur_active));
+                        dcache_vpu_addr_o    = start_addr;
 
-                        // update request buffer
+                        // update request buffer (unit-stride continues from the next aligned word)
                         if (mode_i.stride == VLSU_STRIDED && mode_i.eew == VSEW_64) begin
-                            request_buffer_n.addr = base_address_i;
+                            request_buffer_n.addr = start_addr;
+                        end else if (mode_i.stride == VLSU_UNITSTRIDE) begin
+                            request_buffer_n.addr = {start_addr[31:2], 2'b00} + load_addr_offset;
                         end else begin
-                            request_buffer_n.addr = base_address_i + load_addr_offset;
+                            request_buffer_n.addr = start_addr + load_addr_offset;
                         end
                     end
                 end
@@ -144,8 +272,8 @@ module VPU_lsu (
 
             READ : begin
                 if (!dcache_vpu_wait_i) begin
-                    // send out request to D$
-                    dcache_vpu_request_o = 1'b1;
+                    // send out request to D$, the response of a skipped word is masked out by load_bweb
+                    dcache_vpu_request_o = next_active;
                     dcache_vpu_addr_o    = request_buffer_q.addr;
 
                     // update request buffer
@@ -162,6 +290,16 @@ module VPU_lsu (
                     if (request_buffer_n.vl_count_byte >= vl_byte) begin
                         dcache_vpu_request_o   = 1'b0;
                     end
+
+                    // stopped by a trap : this word is not written back, vstart is at it
+                    if (kill_i) begin
+                        lsu_state_n            = IDLE;
+                        dcache_vpu_request_o   = 1'b0;
+                        request_buffer_n.valid = 1'b0;
+                        result_valid_o         = 1'b0;
+                        vl_update_o            = request_buffer_q.vl_count_byte >> mode_i.eew;
+                        done_o                 = 1'b1;
+                    end
                 end
 
                 if (request_buffer_q.vl_count_byte >= vl_byte) begin
@@ -173,10 +311,99 @@ module VPU_lsu (
                 end
             end
 
+            NT_READ : begin
+                // every beat is written back to the register right away
+                if (nt_out_valid_i) begin
+                    request_buffer_n.vl_count_byte = request_buffer_q.vl_count_byte + load_bytes;
+                    vl_update_o                    = request_buffer_n.vl_count_byte >> mode_i.eew;
+
+                    result_valid_o = 1'b1;
+                    result_addr_o  = rd_addr_i + (request_buffer_q.vl_count_byte >> 3);
+                    result_bweb_o  = load_bweb;
+                    result_data_o  = load_data;
+                end
+
+                if (request_buffer_q.vl_count_byte >= vl_byte) begin
+                    lsu_state_n            = IDLE;
+                    request_buffer_n.valid = 1'b0;
+                    result_valid_o         = 1'b0;
+                    done_o                 = 1'b1;
+                end
+            end
+
+            NT_WRITE : begin
+                // W channel handshake, the next word is ready in the next cycle
+                if (nt_in_ready_i) begin
+                    request_buffer_n.vl_count_byte = request_buffer_q.vl_count_byte + store_bytes;
+                    vl_update_o                    = request_buffer_n.vl_count_byte >> mode_i.eew;
+                end
+
+                // B channel handshake, start to invalidate the stale D$ lines
+                if (request_buffer_q.vl_count_byte >= vl_byte && ~nt_wait_i) begin
+                    lsu_state_n           = NT_INV;
+                    dcache_vpu_request_o  = 1'b1;
+                    dcache_vpu_inv_o      = 1'b1;
+                    dcache_vpu_addr_o     = request_buffer_q.addr;
+                    request_buffer_n.addr = request_buffer_q.addr + LINE_STEP;
+                end
+            end
+
+            NT_INV : begin
+                if (~dcache_vpu_wait_i) begin
+                    if (request_buffer_q.addr <= request_buffer_q.end_addr) begin
+                        dcache_vpu_request_o  = 1'b1;
+                        dcache_vpu_inv_o      = 1'b1;
+                        dcache_vpu_addr_o     = request_buffer_q.addr;
+                        request_buffer_n.addr = request_buffer_q.addr + LINE_STEP;
+                    end else begin
+                        lsu_state_n            = IDLE;
+                        request_buffer_n.valid = 1'b0;
+                        done_o                 = 1'b1;
+                    end
+                end
+            end
+
+            SPM_READ : begin
+                if (request_buffer_q.vl_count_byte >= vl_byte) begin
+                    lsu_state_n            = IDLE;
+                    request_buffer_n.valid = 1'b0;
+                    done_o                 = 1'b1;
+                end else begin
+                    // write back the slice read in the last cycle
+                    result_valid_o = 1'b1;
+                    result_addr_o  = rd_addr_i + (request_buffer_q.vl_count_byte >> 3);
+                    result_bweb_o  = spm_mask;
+                    result_data_o  = spm_out_i;
+
+                    request_buffer_n.vl_count_byte = request_buffer_q.vl_count_byte + spm_bytes;
+                    vl_update_o                    = request_buffer_n.vl_count_byte >> mode_i.eew;
+
+                    // read the next slice
+                    if (request_buffer_n.vl_count_byte < vl_byte) begin
+                        spm_request_o         = 1'b1;
+                        request_buffer_n.addr = request_buffer_q.addr + 32'd8;
+                    end
+                end
+            end
+
+            SPM_WRITE : begin
+                if (request_buffer_q.vl_count_byte >= vl_byte) begin
+                    lsu_state_n            = IDLE;
+                    request_buffer_n.valid = 1'b0;
+                    done_o                 = 1'b1;
+                end else begin
+                    spm_request_o                  = 1'b1;
+                    spm_write_o                    = spm_mask;
+                    request_buffer_n.addr          = request_buffer_q.addr + 32'd8;
+                    request_buffer_n.vl_count_byte = request_buffer_q.vl_count_byte + spm_bytes;
+                    vl_update_o                    = request_buffer_n.vl_count_byte >> mode_i.eew;
+                end
+            end
+
             WRITE : begin
                 if (~dcache_vpu_wait_i) begin
-                    // send out request to D$
-                    dcache_vpu_request_o = 1'b1;
+                    // send out request to D$ (not for a word without active elements)
+                    dcache_vpu_request_o = (|store_bweb);
                     dcache_vpu_addr_o    = request_buffer_q.addr;
                     dcache_vpu_write_o   = store_bweb;
                     dcache_vpu_in_o      = align_data;
@@ -205,6 +432,15 @@ module VPU_lsu (
                         request_buffer_n.addr = request_buffer_q.addr + store_addr_offset;
                     end
 
+                    // stopped by a trap : this word is not sent, vstart is at it
+                    if (kill_i) begin
+                        lsu_state_n            = IDLE;
+                        dcache_vpu_request_o   = 1'b0;
+                        request_buffer_n.valid = 1'b0;
+                        vl_update_o            = request_buffer_q.vl_count_byte >> mode_i.eew;
+                        done_o                 = 1'b1;
+                    end
+
                     if (request_buffer_q.vl_count_byte >= vl_byte) begin
                         lsu_state_n            = IDLE;
                         dcache_vpu_request_o   = 1'b0;
@@ -225,22 +461,71 @@ module VPU_lsu (
         // the total bytes to store (vl_i * eew)
         vl_byte  = {(32-VL_BITS)'(0), vl_i} << mode_i.eew;
 
+        // a new request starts at vl_count_i (vstart of a restarted load / store)
+        start_byte = {(32-VL_BITS)'(0), vl_count_i} << mode_i.eew;
+        start_addr = (mode_i.stride == VLSU_STRIDED) ? (base_address_i + {(32-VL_BITS)'(0), vl_count_i} * (stride_i << mode_i.eew)) :
+                                                       (base_address_i + start_byte);
+
         // the byte left
         if (lsu_state_q == IDLE && valid_i) begin
-            vl_byte_left = vl_byte;
+            vl_byte_left = vl_byte - start_byte;
+            byte_count   = start_byte;
         end else begin
             vl_byte_left = vl_byte - request_buffer_q.vl_count_byte;
+            byte_count   = request_buffer_q.vl_count_byte;
         end
+
+        // a unit-stride word stops at the word boundary
+        unit_addr  = base_address_i + byte_count;
+        unit_bytes = 32'd4 - {30'd0, unit_addr[1:0]};
+
+        if (vl_byte_left < unit_bytes) begin
+            unit_bytes = vl_byte_left;
+        end
+
+        // v0 bit of the element each byte belongs to
+        for (int j = 0; j < 4; j++) begin
+            cur_active[j] = ~mode_i.masked || mask_i[CFG_VL_BITS'((byte_count + 32'(j)) >> mode_i.eew)];
+        end
+
+        // the next load request starts at an aligned word (unit-stride) or the next element (strided)
+        next_count  = byte_count + load_bytes;
+        next_bytes  = (mode_i.stride == VLSU_UNITSTRIDE) ? (vl_byte - next_count) : (32'd1);
+        next_active = 1'b0;
+
+        for (int j = 0; j < 4; j++) begin
+            if (32'(j) < next_bytes && (~mode_i.masked || mask_i[CFG_VL_BITS'((next_count + 32'(j)) >> mode_i.eew)])) begin
+                next_active = 1'b1;
+            end
+        end
+
+        // only a word-aligned unmasked unit-stride access can be a burst, the burst goes to
+        // the slave of its start address and never crosses a 4 KiB boundary, so the access
+        // must be in one 4 KiB page of DM / DRAM (anything else goes through D$)
+        nt_access = VLSU_NT_EN && mode_i.stride == VLSU_UNITSTRIDE && ~mode_i.masked &&
+                    base_address_i[1:0] == 2'b00 && vl_byte != 32'd0 && start_byte == 32'd0 &&
+                    base_address_i[31:12] == 20'((base_address_i + vl_byte - 32'd1) >> 12) &&
+                    ((base_address_i >= `DM_start_addr   && base_address_i + vl_byte - 32'd1 <= `DM_end_addr  ) ||
+                     (base_address_i >= `DRAM_start_addr && base_address_i + vl_byte - 32'd1 <= `DRAM_end_addr));
+
+        // a slice-aligned unmasked unit-stride access inside the VSPM window
+        // moves a whole vreg slice (8 bytes) per cycle
+        spm_access = mode_i.stride == VLSU_UNITSTRIDE && ~mode_i.masked && base_address_i[2:0] == 3'b000 &&
+                     base_address_i >= `VSPM_start_addr && base_address_i + vl_byte - 32'd1 <= `VSPM_end_addr &&
+                     vl_byte != 32'd0 && start_byte == 32'd0;
+
+        spm_bytes = (vl_byte_left < 32'd8) ? (vl_byte_left) : (32'd8);
+        spm_mask  = 8'((16'd1 << spm_bytes) - 16'd1);
     end
 
     // --------------------------------------------
     //             Generate read data             
     // --------------------------------------------
     always_comb begin
-        load_bytes  = (vl_byte_left < 32'd4) ? (vl_byte_left) : (32'd4);
-        load_mask   = 8'b00001111; // we can only writeback 4 bytes in a time
-        load_bweb   = (VLEN/8)'(0);
-        load_data   = (VLEN)'(0);
+        load_bytes  = (mode_i.stride == VLSU_UNITSTRIDE) ? (unit_bytes) : ((vl_byte_left < 32'd4) ? (vl_byte_left) : (32'd4));
+        load_mask   = 16'h000f; // we can only writeback 4 bytes in a time
+        load_bweb   = (VLEN/4)'(0);
+        load_data   = (2*VLEN)'(0);
         data_offset = 32'd0;
 
         if (mode_i.stride == VLSU_STRIDED) begin
@@ -252,33 +537,29 @@ module VPU_lsu (
             endcase
 
             unique case (mode_i.eew)
-                VSEW_8  : load_mask = 8'b00000001;
-                VSEW_16 : load_mask = 8'b00000011;
-                VSEW_32 : load_mask = 8'b00001111;
+                VSEW_8  : load_mask = 16'h0001;
+                VSEW_16 : load_mask = 16'h0003;
+                VSEW_32 : load_mask = 16'h000f;
                 default : ; // nothing to do
             endcase
         end
 
-        // we can handle 4 bytes at one time for UNITSTRIDE
+        // we can handle up to 4 bytes (until the word boundary) at one time for UNITSTRIDE
         if (mode_i.stride == VLSU_UNITSTRIDE) begin
-            unique case (vl_byte_left)
-                32'd1   : load_mask = 8'b00000001;
-                32'd2   : load_mask = 8'b00000011;
-                32'd3   : load_mask = 8'b00000111;
-                default : ; // nothing to do
-            endcase
+            load_mask = 16'((17'd1 << unit_bytes) - 17'd1);
         end
 
         data_offset = {29'd0, request_buffer_q.vl_count_byte[2:0]} << 3'd3;
+        mem_out     = (lsu_state_q == NT_READ) ? (nt_out_i) : (dcache_vpu_out_i);
 
-        // if we have writeback 4 bytes, then mask should shift 4 bits for higer bits (register[63:32])
-        if (lsu_state_q == READ && mode_i.stride == VLSU_UNITSTRIDE) begin
-            load_bweb  = load_mask        << ((request_buffer_q.vl_count_byte[2]) ? (3'd4 ) : (3'd0));
-            load_data  = ({32'd0, dcache_vpu_out_i} << ((request_buffer_q.vl_count_byte[2]) ? (6'd32) : (6'd0)));
+        // the bytes from the word are placed at vl_count_byte, they may cross into the next slice
+        if (lsu_state_q inside {READ, NT_READ} && mode_i.stride == VLSU_UNITSTRIDE) begin
+            load_bweb  = (load_mask & {12'd0, cur_active}) << request_buffer_q.vl_count_byte[2:0];
+            load_data  = (2*VLEN)'(mem_out >> ({30'd0, unit_addr[1:0]} << 3)) << data_offset;
         // if stirde --> load bweb is base on element index
         end else if (lsu_state_q == READ && mode_i.stride == VLSU_STRIDED) begin
-            load_bweb  = load_mask        << request_buffer_q.vl_count_byte[2:0];
-            load_data  = ({32'd0, dcache_vpu_out_i} << data_offset);
+            load_bweb  = (load_mask & {12'd0, cur_active}) << request_buffer_q.vl_count_byte[2:0];
+            load_data  = (2*VLEN)'(mem_out) << data_offset;
         end
     end
 
@@ -302,14 +583,9 @@ module VPU_lsu (
         store_data = 32'd0;
         align_data = 32'd0;
 
-        // we can handle 4 bytes at one time for UNITSTRIDE
+        // we can handle up to 4 bytes (until the word boundary) at one time for UNITSTRIDE
         if (mode_i.stride == VLSU_UNITSTRIDE) begin
-            unique case (vl_byte_left)
-                32'd1   : store_mask = 4'b0001;
-                32'd2   : store_mask = 4'b0011;
-                32'd3   : store_mask = 4'b0111;
-                default : ; // nothing to do
-            endcase
+            store_mask = 4'((5'd1 << unit_bytes) - 5'd1);
         end else if (mode_i.stride == VLSU_STRIDED) begin
             // in STRIDE mode, we can only handle one element one time
             // when eew = 8  --> store_mask = 4'b1
@@ -327,30 +603,34 @@ module VPU_lsu (
 
         // the data for first write
         if (lsu_state_q == IDLE && valid_i) begin
-            store_bweb = store_mask << base_address_i[1:0];
-            store_data = store_data_i[31:0];
-            align_data = store_data << ( {30'd0, base_address_i[1:0]} << 32'd3 );
+            store_bweb = (store_mask & cur_active) << start_addr[1:0];
+            store_data = 32'(store_data_i >> ({29'd0, start_byte[2:0]} << 3));
+            align_data = store_data << ( {30'd0, start_addr[1:0]} << 32'd3 );
         end
 
+        // the source bytes start at vl_count_byte and may cross into the next slice
         if (lsu_state_q == WRITE) begin
-            store_bweb = store_mask << request_buffer_q.addr[1:0];
-            store_data = (request_buffer_q.vl_count_byte[2]) ? (store_data_i[63:32]) : (store_data_i[31:0]);
+            store_bweb = (store_mask & cur_active) << request_buffer_q.addr[1:0];
+            store_data = 32'(store_data_i >> ({29'd0, request_buffer_q.vl_count_byte[2:0]} << 3));
             align_data = store_data << ( {30'd0, request_buffer_q.addr[1:0]} << 32'd3 );
         end
+
+        // non-temporal burst is always word-aligned
+        if (lsu_state_q == NT_WRITE) begin
+            store_bweb = store_mask;
+            store_data = (request_buffer_q.vl_count_byte[2]) ? (store_data_i[63:32]) : (store_data_i[31:0]);
+            align_data = store_data;
+        end
     end
 
     always_comb begin
         store_bytes       = 32'd0;
         store_addr_offset = 32'd0;
 
-        // calculate how many bytes we store in this request
-        unique case (store_bweb)
-            4'b1111 : store_bytes = 32'd4;
-            4'b0111 : store_bytes = 32'd3;
-            4'b0011 : store_bytes = 32'd2;
-            4'b0001 : store_bytes = 32'd1;
-            default : store_bytes = 32'd0;
-        endcase
+        // calculate how many bytes we move in this request (inactive bytes are skipped, not stored)
+        for (int i = 0; i < 4; i++) begin
+            store_bytes = store_bytes + 32'(store_mask[i]);
+        end
 
         unique case (mode_i.stride)
             VLSU_UNITSTRIDE : store_addr_offset = store_bytes;
@@ -5,30 +5,116 @@ module VPU_mask (
     input  logic [VL_BITS-1:0] vl_i,
     input  logic [VL_BITS-1:0] vl_count_i,
     output logic [VL_BITS-1:0] vl_update_o,
+    input  VSEW_e              vsew_i,
     input  logic [4:0]         rd_addr_i,
     output logic               done_o,
 
     // input operand source
     input  logic [VLEN-1:0]    rs1_val_i,
     input  logic [VLEN-1:0]    rs2_val_i,
+    input  logic [VLEN-1:0]    rs3_val_i, // old vd (for mask undisturbed)
+    input  logic [VLEN-1:0]    vreg_v0_i,
 
     // output result
     output logic               result_valid_o,
     output logic [4:0]         result_addr_o,
     output logic [VLEN/8-1:0]  result_bweb_o,
-    output logic [VLEN-1:0]    result_data_o
+    output logic [VLEN-1:0]    result_data_o,
+
+    // scalar result (vcpop / vfirst)
+    output logic               xreg_result_valid_o,
+    output logic [31:0]        xreg_result_o
 );
 
     // --------------------------------------------
     //              Signal Declaration             
     // --------------------------------------------
-    logic [63:0] result;
+    localparam int unsigned IDX_BITS     = $clog2(VLEN);
+    localparam int unsigned CNT_BITS     = $clog2(VLEN) + 1;
+    localparam int unsigned SLICE_SHIFT  = $clog2(VLEN/8); // log2(elements per slice when SEW = 8)
+
+    // element selection
+    logic [VLEN-1:0]                            body;     // elements before vl
+    logic [VLEN-1:0]                            active;   // body elements enabled by v0
+    logic [VLEN-1:0]                            mask_src; // active source mask bits
+
+    // parallel prefix popcount network (Kogge-Stone)
+    logic [IDX_BITS:0][VLEN-1:0][CNT_BITS-1:0]  prefix_cnt;
+    logic [VLEN-1:0][CNT_BITS-1:0]              iota;      // exclusive prefix count
+    logic [VLEN-1:0]                            found_inc; // set bit found in [0, i]
+    logic [VLEN-1:0]                            found_exc; // set bit found in [0, i)
+    logic [VLEN-1:0]                            first_hot; // one-hot of first set bit
+
+    // scalar result
+    logic [CNT_BITS-1:0]                        popcount;
+    logic [IDX_BITS-1:0]                        first_idx;
+
+    // slice generate
+    logic [VL_BITS-1:0]                         max_elements;
+    logic [VL_BITS-1:0]                         handled_elements;
+    logic [IDX_BITS-1:0]                        elem_idx;
+    logic [63:0]                                elem_value;
+    logic [VLEN-1:0]                            logic_result;
+    logic [VLEN-1:0]                            mask_result;
+    logic [VLEN/8-1:0]                          elem_bweb;
+    logic [VLEN-1:0]                            elem_result;
+
+    // --------------------------------------------
+    //              Element Selection              
+    // --------------------------------------------
+    always_comb begin
+        for (int i = 0; i < VLEN; i++) begin
+            body[i] = (i < {(32-VL_BITS)'(0), vl_i});
+        end
+
+        active   = (vmask_ctrl_i.masked) ? (body & vreg_v0_i) : (body);
+        mask_src = rs2_val_i & active;
+    end
+
+    // --------------------------------------------
+    //          Parallel Prefix Popcount           
+    // --------------------------------------------
+    // level 0 holds the source bits, level k holds the
+    // count of the 2^k bits ending at i, the last level
+    // is the inclusive prefix count of the whole mask
+    always_comb begin
+        for (int i = 0; i < VLEN; i++) begin
+            prefix_cnt[0][i] = CNT_BITS'(mask_src[i]);
+        end
+
+        for (int l = 0; l < IDX_BITS; l++) begin
+            for (int i = 0; i < VLEN; i++) begin
+                prefix_cnt[l+1][i] = prefix_cnt[l][i];
+
+                if (i >= (1 << l)) begin
+                    prefix_cnt[l+1][i] = prefix_cnt[l][i] + prefix_cnt[l][i - (1 << l)];
+                end
+            end
+        end
+
+        for (int i = 0; i < VLEN; i++) begin
+            iota[i]      = prefix_cnt[IDX_BITS][i] - CNT_BITS'(mask_src[i]);
+            found_inc[i] = (prefix_cnt[IDX_BITS][i] != CNT_BITS'(0));
+            found_exc[i] = (iota[i] != CNT_BITS'(0));
+        end
+
+        first_hot = mask_src & ~found_exc;
+        popcount  = prefix_cnt[IDX_BITS][VLEN-1];
+
+        // first_hot is one-hot, so OR-ing the indices encodes it
+        first_idx = IDX_BITS'(0);
+        for (int i = 0; i < VLEN; i++) begin
+            if (first_hot[i]) first_idx = first_idx | IDX_BITS'(i);
+        end
+    end
 
     // --------------------------------------------
     //                   Calculate                 
     // --------------------------------------------
+    // mask logical / mask producing instructions (whole mask in one cycle)
     always_comb begin
-        result = 64'b0;
+        logic_result = VLEN'(0);
+        mask_result  = VLEN'(0);
 
         // ------------------------------------------------
         // Note that the spec states:
@@ -36,29 +122,86 @@ module VPU_mask (
         // > are always updated with a tail-agnostic policy
         // ------------------------------------------------
         unique case (vmask_ctrl_i.op)
-            VMAND    : result =   rs2_val_i & rs1_val_i;
-            VMOR     : result =   rs2_val_i | rs1_val_i;
-            VMXOR    : result =   rs2_val_i ^ rs1_val_i;
-            VMNAND   : result = ~(rs2_val_i & rs1_val_i);
-            VMNOR    : result = ~(rs2_val_i | rs1_val_i);
-            VMXNOR   : result = ~(rs2_val_i ^ rs1_val_i);
-            VMORNOT  : result =   rs2_val_i & ~rs1_val_i;
-            VMANDNOT : result =   rs2_val_i | ~rs1_val_i;
+            VMAND    : logic_result =   rs2_val_i & rs1_val_i;
+            VMOR     : logic_result =   rs2_val_i | rs1_val_i;
+            VMXOR    : logic_result =   rs2_val_i ^ rs1_val_i;
+            VMNAND   : logic_result = ~(rs2_val_i & rs1_val_i);
+            VMNOR    : logic_result = ~(rs2_val_i | rs1_val_i);
+            VMXNOR   : logic_result = ~(rs2_val_i ^ rs1_val_i);
+            VMORNOT  : logic_result =   rs2_val_i | ~rs1_val_i;
+            VMANDNOT : logic_result =   rs2_val_i & ~rs1_val_i;
             default  : ; // nothing to do
         endcase
+
+        unique case (vmask_ctrl_i.op)
+            VMSBF   : mask_result = ~found_inc;
+            VMSIF   : mask_result = ~found_exc;
+            VMSOF   : mask_result = first_hot;
+            default : ; // nothing to do
+        endcase
+
+        // inactive and tail elements keep the old vd value
+        mask_result = (mask_result & active) | (rs3_val_i & ~active);
+    end
+
+    // element producing instructions (one vd slice per cycle)
+    always_comb begin
+        max_elements     = VL_BITS'(VLEN/8) >> vsew_i;
+        handled_elements = vl_i - vl_count_i;
+        elem_bweb        = (VLEN/8)'(0);
+        elem_result      = VLEN'(0);
+
+        if (handled_elements > max_elements) begin
+            handled_elements = max_elements;
+        end
+
+        for (int b = 0; b < VLEN/8; b++) begin
+            // byte b belongs to element (b >> vsew) of the current slice
+            elem_idx   = IDX_BITS'(vl_count_i) + IDX_BITS'(b >> vsew_i);
+            elem_value = (vmask_ctrl_i.op == VID) ? (64'(elem_idx)) : (64'(iota[elem_idx]));
+
+            elem_result[b*8 +: 8] = elem_value[(b & ((1 << vsew_i) - 1))*8 +: 8];
+            elem_bweb[b]          = active[elem_idx] && ((b >> vsew_i) < {(32-VL_BITS)'(0), handled_elements});
+        end
     end
 
     // --------------------------------------------
     //                Result WriteBack             
     // --------------------------------------------
-    assign done_o = valid_i && (vl_count_i == vl_i);
+    assign done_o = valid_i && ((vl_count_i == vl_i) || vmask_ctrl_i.xreg);
 
     always_comb begin
-        result_valid_o = valid_i; // VMASK can alway finish in one cycle
-        result_addr_o  = rd_addr_i;
-        result_bweb_o  = 8'b11111111;
-        result_data_o  = result;
-        vl_update_o    = vl_i;
+        result_valid_o      = valid_i && ~vmask_ctrl_i.xreg;
+        result_addr_o       = rd_addr_i;
+        result_bweb_o       = {(VLEN/8){1'b1}};
+        result_data_o       = logic_result;
+        vl_update_o         = vl_i; // whole mask finish in one cycle
+
+        xreg_result_valid_o = valid_i && vmask_ctrl_i.xreg;
+        xreg_result_o       = 32'd0;
+
+        unique case (vmask_ctrl_i.op)
+            VMSBF, VMSIF, VMSOF : begin
+                result_data_o = mask_result;
+            end
+
+            VIOTA, VID : begin
+                result_addr_o = rd_addr_i + 5'(vl_count_i >> (SLICE_SHIFT - vsew_i));
+                result_bweb_o = elem_bweb;
+                result_data_o = elem_result;
+                vl_update_o   = handled_elements;
+            end
+
+            VCPOP : begin
+                xreg_result_o = 32'(popcount);
+            end
+
+            VFIRST : begin
+                xreg_result_o = (|mask_src) ? (32'(first_idx)) : (32'hFFFFFFFF);
+            end
+
+            default : ; // nothing to do
+        endcase
     end
 
 endmodule
\ No newline at end of file
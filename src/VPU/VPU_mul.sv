@@ -17,7 +17,10 @@ module VPU_mul (
     // mul result
     output logic        result_valid_o,
     output logic        result_en_o,
-    output logic [63:0] result_o
+    output logic [63:0] result_o,
+
+    // request to fixed-point stage
+    output VFIXP_REQ_t  fixp_o
 );
 
     // --------------------------------------------
@@ -36,7 +39,6 @@ module VPU_mul (
     logic [ 17:0] mul_18;  //  9 *  9 -> 18  bit
 
     mul_operand_t operand1, operand2, operand3;
-    logic         r8, r16, r32, r64; // rounding increment
     mul_operand_t result;            // for stage 1
     
     // pipeline register
@@ -100,65 +102,28 @@ module VPU_mul (
             mul_result_q <= 130'd0;
         end else begin
             valid_q      <= valid_i;
-            vmul_ctrl_q  <= vmul_ctrl_i;
-            vsew_q       <= vsew_i;
-            vxrm_q       <= vxrm_i;
-            operand3_q   <= operand3;
-            mask_q       <= mask_i;
-            mul_result_q <= mul_result_n;
+
+            // datapath registers only load for a valid lane (clock-gate enable)
+            if (valid_i) begin
+                vmul_ctrl_q  <= vmul_ctrl_i;
+                vsew_q       <= vsew_i;
+                vxrm_q       <= vxrm_i;
+                operand3_q   <= operand3;
+                mask_q       <= mask_i;
+                mul_result_q <= mul_result_n;
+            end
         end
     end
 
     // --------------------------------------------
     //        Stage 1 : Result Mux and Adder       
     // --------------------------------------------
-    // find out rounding increment
-    always_comb begin
-        r8  = 1'b0;
-        r16 = 1'b0;
-        r32 = 1'b0;
-        r64 = 1'b0;
-
-        unique case (vxrm_q)
-            VXRM_RNU : begin
-                r8  = mul_result_q[ 6];
-                r16 = mul_result_q[14];
-                r32 = mul_result_q[30];
-                r64 = mul_result_q[62];
-            end
-
-            VXRM_RNE : begin
-                r8  = mul_result_q[ 6] & (mul_result_q[ 5:0] !=  6'd0 | mul_result_q[ 7]);
-                r16 = mul_result_q[14] & (mul_result_q[13:0] != 14'd0 | mul_result_q[15]);
-                r32 = mul_result_q[30] & (mul_result_q[29:0] != 30'd0 | mul_result_q[31]);
-                r64 = mul_result_q[62] & (mul_result_q[61:0] != 62'd0 | mul_result_q[63]);
-            end
-
-            VXRM_RDN : begin
-                r8  = 1'b0;
-                r16 = 1'b0;
-                r32 = 1'b0;
-                r64 = 1'b0;
-            end
-
-            VXRM_ROD : begin
-                r8  = mul_result_q[ 7] & (mul_result_q[ 6:0] !=  7'd0);
-                r16 = mul_result_q[15] & (mul_result_q[14:0] != 15'd0);
-                r32 = mul_result_q[31] & (mul_result_q[30:0] != 31'd0);
-                r64 = mul_result_q[63] & (mul_result_q[62:0] != 63'd0);
-            end
-
-            default : ;
-        endcase
-    end
-
-
     always_comb begin
         result = 64'd0;
 
         unique case (vmul_ctrl_q.op)
             VMUL_VMUL : begin
-                unique case (vsew_i)
+                unique case (vsew_q)
                     VSEW_8  : result.w8 [0] = mul_result_q[ 7:0];
                     VSEW_16 : result.w16[0] = mul_result_q[15:0];
                     VSEW_32 : result.w32[0] = mul_result_q[31:0];
@@ -168,7 +133,7 @@ module VPU_mul (
             end
 
             VMUL_VMULH : begin
-                unique case (vsew_i)
+                unique case (vsew_q)
                     VSEW_8  : result.w8 [0] = mul_result_q[ 15: 8];
                     VSEW_16 : result.w16[0] = mul_result_q[ 31:16];
                     VSEW_32 : result.w32[0] = mul_result_q[ 63:32];
@@ -178,7 +143,7 @@ module VPU_mul (
             end
 
             VMUL_VMACC : begin
-                unique case (vsew_i)
+                unique case (vsew_q)
                     VSEW_8  : result.w8 [0] = (mul_result_q[ 7:0]) + operand3_q.w8 [0];
                     VSEW_16 : result.w16[0] = (mul_result_q[15:0]) + operand3_q.w16[0];
                     VSEW_32 : result.w32[0] = (mul_result_q[31:0]) + operand3_q.w32[0];
@@ -188,7 +153,7 @@ module VPU_mul (
             end
 
             VMUL_VNMSUB : begin
-                unique case (vsew_i)
+                unique case (vsew_q)
                     VSEW_8  : result.w8 [0] = (-mul_result_q[ 7:0]) + operand3_q.w8 [0];
                     VSEW_16 : result.w16[0] = (-mul_result_q[15:0]) + operand3_q.w16[0];
                     VSEW_32 : result.w32[0] = (-mul_result_q[31:0]) + operand3_q.w32[0];
@@ -197,18 +162,26 @@ module VPU_mul (
                 endcase
             end
 
-            VMUL_VSMUL : begin
-                unique case (vsew_i)
-                    VSEW_8  : result.w8 [0] = (mul_result_q[ 7:0] >>  7) + r8;
-                    VSEW_16 : result.w16[0] = (mul_result_q[15:0] >> 15) + r16;
-                    VSEW_32 : result.w32[0] = (mul_result_q[31:0] >> 31) + r32;
-                    VSEW_64 : result.w64    = (mul_result_q[63:0] >> 63) + r64;
-                    default : ;
-                endcase
-            end
-
             default : ; // nothing to do
         endcase
     end
 
+    // vsmul : clip(roundoff_signed(vs2 * vs1, SEW - 1))
+    always_comb begin
+        fixp_o         = VFIXP_REQ_t'(0);
+        fixp_o.valid   = valid_q && (vmul_ctrl_q.op == VMUL_VSMUL);
+        fixp_o.signext = 1'b1;
+        fixp_o.clip    = 1'b1;
+        fixp_o.vsew    = vsew_q;
+        fixp_o.vxrm    = vxrm_q;
+
+        unique case (vsew_q)
+            VSEW_8  : {fixp_o.shift, fixp_o.value} = {7'd7 , {{112{mul_result_q[ 17]}}, mul_result_q[ 17:0]}};
+            VSEW_16 : {fixp_o.shift, fixp_o.value} = {7'd15, {{ 96{mul_result_q[ 33]}}, mul_result_q[ 33:0]}};
+            VSEW_32 : {fixp_o.shift, fixp_o.value} = {7'd31, {{ 64{mul_result_q[ 65]}}, mul_result_q[ 65:0]}};
+            VSEW_64 : {fixp_o.shift, fixp_o.value} = {7'd63, mul_result_q};
+            default : ;
+        endcase
+    end
+
 endmodule
\ No newline at end of file
@@ -3,15 +3,16 @@ module VPU_regfile (
     input  logic                 rst_i,
 
     // read port (3 ports, and 1 v0 read port)
-    input  logic [2:0][4:0]      vreg_read_addr_i,
-    output logic [2:0][VLEN-1:0] vreg_read_data_o,
-    output logic [VLEN-1:0]      vreg_v0_o,
+    // each port reads VREG_SLICES consecutive vregs starting at the address
+    input  logic [2:0][4:0]          vreg_read_addr_i,
+    output logic [2:0][VGRP_LEN-1:0] vreg_read_data_o,
+    output logic [VLEN-1:0]          vreg_v0_o,
 
-    // write port (1 ports)
-    input  logic                 vreg_write_en_i,
-    input  logic [4:0]           vreg_write_addr_i,
-    input  logic [VLEN/8-1:0]    vreg_write_bweb_i,
-    input  logic [VLEN-1:0]      vreg_write_data_i
+    // write port (1 ports, VREG_SLICES consecutive vregs starting at the address)
+    input  logic                     vreg_write_en_i,
+    input  logic [4:0]               vreg_write_addr_i,
+    input  logic [VGRP_LEN/8-1:0]    vreg_write_bweb_i,
+    input  logic [VGRP_LEN-1:0]      vreg_write_data_i
 );
 
     // --------------------------------------------
@@ -22,11 +23,16 @@ module VPU_regfile (
     // --------------------------------------------
     //               Registers update              
     // --------------------------------------------
-    assign vreg_v0_o           = register[0];
-    assign vreg_read_data_o[0] = register[vreg_read_addr_i[0]];
-    assign vreg_read_data_o[1] = register[vreg_read_addr_i[1]];
-    assign vreg_read_data_o[2] = register[vreg_read_addr_i[2]];
-    
+    assign vreg_v0_o = register[0];
+
+    always_comb begin
+        for (int p = 0; p < 3; p++) begin
+            for (int s = 0; s < VREG_SLICES; s++) begin
+                vreg_read_data_o[p][s*VLEN +: VLEN] = register[vreg_read_addr_i[p] + 5'(s)];
+            end
+        end
+    end
+
     always_ff @(posedge clk_i) begin
         if (rst_i) begin
             foreach (register[i]) begin
@@ -34,9 +40,11 @@ module VPU_regfile (
             end
         end else begin
             // update architectural state
-            for (int i = 0; i < VLEN / 8; i++) begin
-                if (vreg_write_en_i && vreg_write_bweb_i[i]) begin
-                    register[vreg_write_addr_i][i*8 +: 8] <= vreg_write_data_i[i*8 +: 8];
+            for (int s = 0; s < VREG_SLICES; s++) begin
+                for (int i = 0; i < VLEN / 8; i++) begin
+                    if (vreg_write_en_i && vreg_write_bweb_i[s*(VLEN/8) + i]) begin
+                        register[vreg_write_addr_i + 5'(s)][i*8 +: 8] <= vreg_write_data_i[s*VLEN + i*8 +: 8];
+                    end
                 end
             end
         end
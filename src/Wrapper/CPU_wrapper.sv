@@ -6,6 +6,13 @@ module CPU_wrapper (
     input  logic                      DMA_interrupt_i,
     input  logic                      WDT_interrupt_i,
 
+    // DMA snoop, D$ cleans / drops the lines of a DMA burst
+    input  logic                      snoop_req_i,
+    input  CMO_t                      snoop_cmo_i,
+    input  logic [31:0]               snoop_addr_i,
+    input  logic [ 3:0]               snoop_len_i,
+    output logic                      snoop_wait_o,
+
     // AXI MASTER0 INTERFACE
     // AR channel
     output logic [`AXI_ID_BITS  -1:0] ARID_M0,
@@ -76,7 +83,50 @@ module CPU_wrapper (
     input  logic [`AXI_ID_BITS  -1:0] BID_M1,
     input  logic [1:0]                BRESP_M1,
     input  logic                      BVALID_M1,
-    output logic                      BREADY_M1
+    output logic                      BREADY_M1,
+
+    // MASTER3 INTERFACE (vector non-temporal load/store)
+    // AR channel
+    output logic [`AXI_ID_BITS  -1:0] ARID_M3,
+    output logic [`AXI_DATA_BITS-1:0] ARADDR_M3,
+    output logic [`AXI_LEN_BITS -1:0] ARLEN_M3,
+    output logic [`AXI_SIZE_BITS-1:0] ARSIZE_M3,
+    output logic [1:0]                ARBURST_M3,
+    output logic                      ARVALID_M3,
+    input  logic                      ARREADY_M3,
+    // R channel
+    input  logic [`AXI_ID_BITS  -1:0] RID_M3,
+    input  logic [`AXI_DATA_BITS-1:0] RDATA_M3,
+    input  logic [1:0]                RRESP_M3,
+    input  logic                      RLAST_M3,
+    input  logic                      RVALID_M3,
+    output logic                      RREADY_M3,
+    // AW channel
+    output logic [`AXI_ID_BITS  -1:0] AWID_M3,
+    output logic [`AXI_ADDR_BITS-1:0] AWADDR_M3,
+    output logic [`AXI_LEN_BITS -1:0] AWLEN_M3,
+    output logic [`AXI_SIZE_BITS-1:0] AWSIZE_M3,
+    output logic [1:0]                AWBURST_M3,
+    output logic                      AWVALID_M3,
+    input  logic                      AWREADY_M3,
+    // W channel
+    output logic [`AXI_DATA_BITS-1:0] WDATA_M3,
+    output logic [`AXI_STRB_BITS-1:0] WSTRB_M3,
+    output logic                      WLAST_M3,
+    output logic                      WVALID_M3,
+    input  logic                      WREADY_M3,
+    // B channel
+    input  logic [`AXI_ID_BITS  -1:0] BID_M3,
+    input  logic [1:0]                BRESP_M3,
+    input  logic                      BVALID_M3,
+    output logic                      BREADY_M3,
+
+    // VPU <-> vector scratchpad (64 bit per cycle)
+    output logic                      vspm_request_o,
+    output logic [ 7:0]               vspm_write_o,
+    output logic [31:0]               vspm_addr_o,
+    output logic [63:0]               vspm_in_o,
+    input  logic [63:0]               vspm_out_i
 );
 
     // --------------------------------------------
@@ -95,16 +145,31 @@ module CPU_wrapper (
         logic [ 3:0] strb;
     } REQUEST_t;
 
+    // non-temporal burst request buffer
+    typedef struct packed {
+        logic                      valid;
+        logic [31:0]               addr;
+        logic [`AXI_LEN_BITS -1:0] len;
+        logic [`AXI_LEN_BITS -1:0] count; // how many beats have been sent
+    } BURST_REQUEST_t;
+
     // state machine
-    AXI_STATE_t  fetch_state_q, fetch_state_n;
-    AXI_STATE_t  ls_state_q, ls_state_n;
+    AXI_STATE_t     fetch_state_q, fetch_state_n;
+    AXI_STATE_t     ls_state_q, ls_state_n;
+    AXI_STATE_t     nt_state_q, nt_state_n;
 
     // request buffer
-    REQUEST_t    fetch_request_q, fetch_request_n;
-    REQUEST_t    ls_request_q, ls_request_n;
+    REQUEST_t       fetch_request_q, fetch_request_n;
+    REQUEST_t       ls_request_q, ls_request_n;
+    BURST_REQUEST_t nt_request_q, nt_request_n;
+
+    // master1 burst (D$ line fill / write-back)
+    logic [`AXI_LEN_BITS-1:0] ls_len_q, ls_len_n;
+    logic [`AXI_LEN_BITS-1:0] ls_count_q, ls_count_n; // how many write beats have been sent
 
     // master0 <-> I$
     logic        icache_request;
+    logic [ 3:0] icache_len;
     logic [31:0] icache_addr;
     logic        icache_wait;
     logic        icache_out_valid;
@@ -113,24 +178,49 @@ module CPU_wrapper (
     // master1 <-> D$
     logic        dcache_request;
     logic [ 3:0] dcache_write;
+    logic [ 3:0] dcache_len;
     logic [31:0] dcache_addr;
     logic [31:0] dcache_in;
+    logic        dcache_in_ready;
     logic        dcache_wait;
     logic        dcache_out_valid;
     logic [31:0] dcache_out;
 
+    // I$ <-> L2 (straight to master0 without L2)
+    logic        l1i_request;
+    logic [ 3:0] l1i_len;
+    logic [31:0] l1i_addr;
+    logic        l1i_wait;
+    logic        l1i_out_valid;
+    logic [31:0] l1i_out;
+
+    // D$ <-> L2 (straight to master1 without L2)
+    logic        l1d_request;
+    logic [ 3:0] l1d_write;
+    logic [ 3:0] l1d_len;
+    logic [31:0] l1d_addr;
+    logic [31:0] l1d_in;
+    logic        l1d_in_ready;
+    logic        l1d_wait;
+    logic        l1d_out_valid;
+    logic [31:0] l1d_out;
+
     // CPU <-> I$
     logic        icache_core_request; // memory access request from CPU
     logic [31:0] icache_core_pc;      // pc from CPU
     logic        icache_core_wait;    // wait signal to CPU
     logic [31:0] icache_core_addr;    // address to CPU
     logic [31:0] icache_core_out;     // read data to CPU
+    logic        icache_pf_request;   // BTB-predicted fetch target
+    logic [31:0] icache_pf_addr;
 
     // CPU <-> D$
     logic        dcache_core_request; // memory access request from CPU
     logic [ 3:0] dcache_core_write;   // write byte, half, or word from CPU
     logic [31:0] dcache_core_addr;    // address from CPU
     logic [31:0] dcache_core_in;      // write data from CPU
+    logic [31:0] dcache_core_pc;      // pc of the load / store
+    CMO_t        dcache_core_cmo;     // cache maintenance from CPU
     logic        dcache_core_wait;    // wait signal to CPU
     logic [31:0] dcache_core_out;     // read data to CPU
 
@@ -142,6 +232,7 @@ module CPU_wrapper (
     logic        vector_ack;
     logic        vector_writeback;
     logic        vector_pend_lsu;
+    logic        vector_trap;
     logic        vector_lsu_valid;
     logic        vector_result_valid;
     logic [31:0] vector_result;
@@ -155,6 +246,33 @@ module CPU_wrapper (
     // response from D$
     logic        dcache_vpu_wait;
     logic [31:0] dcache_vpu_out;
+    logic        dcache_vpu_inv;
+    logic        dcache_sb_empty;
+
+    // cache maintenance, D$ -> L2 line / whole invalidate, fence.i -> I$
+    logic        dcache_cmo_busy;     // a CMO (or its write-back) is not done, I$ waits for it
+    logic        icache_inv;          // fence.i, I$ drops every line
+    logic        l2_inv_request;
+    logic        l2_inv_all;
+    logic [31:0] l2_inv_addr;
+    logic        l2_inv_busy;
+
+    // VPU prefetch hint -> D$
+    logic        dcache_pf_request;
+    logic [31:0] dcache_pf_addr;
+    logic [31:0] dcache_pf_end;
+
+    // master3 <-> VPU (non-temporal burst)
+    logic        vpu_nt_request;
+    logic        vpu_nt_write;
+    logic [31:0] vpu_nt_addr;
+    logic [ 3:0] vpu_nt_len;
+    logic [31:0] vpu_nt_in;
+    logic [ 3:0] vpu_nt_strb;
+    logic        vpu_nt_in_ready;
+    logic        vpu_nt_wait;
+    logic        vpu_nt_out_valid;
+    logic [31:0] vpu_nt_out;
 
     // --------------------------------------------
     //    Master0: Instruction Fetch (Read Only)   
@@ -176,9 +294,9 @@ module CPU_wrapper (
         // default AXI master output assignment
         ARVALID_M0 = 1'b0;
         ARID_M0    = `AXI_ID_BITS'd0;
-        ARLEN_M0   = 4'h3;
+        ARLEN_M0   = icache_len;
         ARSIZE_M0  = `AXI_SIZE_WORD;
-        ARBURST_M0 = `AXI_BURST_INC;
+        ARBURST_M0 = `AXI_BURST_WRAP; // I$ line fill, from the missing word
         ARADDR_M0  = `AXI_ADDR_BITS'd0;
         RREADY_M0  = 1'b0;
         AWVALID_M0 = 1'b0;
@@ -251,38 +369,51 @@ module CPU_wrapper (
         if (rst_i) begin
             ls_state_q   <= IDLE;
             ls_request_q <= REQUEST_t'(0);
+            ls_len_q     <= `AXI_LEN_ONE;
+            ls_count_q   <= `AXI_LEN_BITS'd0;
         end else begin
             ls_state_q   <= ls_state_n;
             ls_request_q <= ls_request_n;
+            ls_len_q     <= ls_len_n;
+            ls_count_q   <= ls_count_n;
         end
     end
 
+    // ---------------------------------------------------------------
+    // D$ sends a line fill / write-back as a 4-beat burst and an
+    // uncached access as a single beat. A line fill is a WRAP burst
+    // from the missing word. Write beats come from D$ directly
+    // (dcache_in_ready moves it to the next word).
+    // ---------------------------------------------------------------
     always_comb begin
         ls_state_n   = ls_state_q;
         ls_request_n = ls_request_q;
+        ls_len_n     = ls_len_q;
+        ls_count_n   = ls_count_q;
 
         // default AXI master output assignment
         ARVALID_M1 = 1'b0;
         ARID_M1    = 4'd0;
-        ARLEN_M1   = 4'h3;
+        ARLEN_M1   = ls_len_q;
         ARSIZE_M1  = `AXI_SIZE_WORD;
-        ARBURST_M1 = `AXI_BURST_INC;
+        ARBURST_M1 = (ls_len_q != `AXI_LEN_ONE) ? (`AXI_BURST_WRAP) : (`AXI_BURST_INC);
         ARADDR_M1  = `AXI_ADDR_BITS'd0;
         RREADY_M1  = 1'b0;
         AWVALID_M1 = 1'b0;
         AWID_M1    = 4'd0;
-        AWLEN_M1   = `AXI_LEN_ONE;
+        AWLEN_M1   = ls_len_q;
         AWSIZE_M1  = `AXI_SIZE_WORD;
         AWBURST_M1 = `AXI_BURST_INC;
         AWADDR_M1  = `AXI_ADDR_BITS'd0;
         WVALID_M1  = 1'b0;
-        WDATA_M1   = `AXI_DATA_BITS'd0;
-        WSTRB_M1   = `AXI_STRB_WORD;
+        WDATA_M1   = dcache_in;
+        WSTRB_M1   = dcache_write;
         WLAST_M1   = 1'b0;
         BREADY_M1  = 1'b0;
 
         // default dcache response assignment
         dcache_wait      = ls_request_q.valid | dcache_request;
+        dcache_in_ready  = 1'b0;
         dcache_out_valid = 1'b0;
         dcache_out       = ls_request_q.data;
 
@@ -294,33 +425,42 @@ module CPU_wrapper (
                     // assume load request
                     ls_state_n   = AR_TRANS;
                     ls_request_n = {1'b1, dcache_addr, dcache_in, dcache_write};
+                    ls_len_n     = dcache_len;
 
                     // actually we can send request to AXI bridge right now
                     // if AR handshake, go to next rdata state to receive data
                     ARVALID_M1 = 1'b1;
                     ARADDR_M1  = ls_request_n.addr;
+                    ARLEN_M1   = ls_len_n;
+                    ARBURST_M1 = (ls_len_n != `AXI_LEN_ONE) ? (`AXI_BURST_WRAP) : (`AXI_BURST_INC);
 
                     if (ARREADY_M1) ls_state_n = RDATA_TRANS;
 
                 end else if (dcache_request) begin
                     ls_state_n   = AW_TRANS;
                     ls_request_n = {1'b1, dcache_addr, dcache_in, dcache_write};
+                    ls_len_n     = dcache_len;
+                    ls_count_n   = `AXI_LEN_BITS'd0;
 
                     // actually we can send request to AXI bridge right now
                     // if AW handshake, go to next to send data
                     // to speed up, the W channel can send right away when AW channel handshake
                     AWVALID_M1 = 1'b1;
                     AWADDR_M1  = ls_request_n.addr;
+                    AWLEN_M1   = ls_len_n;
 
                     if (AWREADY_M1) begin
                         ls_state_n = WDATA_TRANS;
 
                         WVALID_M1 = 1'b1;
-                        WLAST_M1  = 1'b1;
-                        WSTRB_M1  = ls_request_n.strb;
-                        WDATA_M1  = ls_request_n.data;
+                        WLAST_M1  = (ls_len_n == `AXI_LEN_ONE);
+
+                        if (WREADY_M1) begin
+                            dcache_in_ready = 1'b1;
+                            ls_count_n      = `AXI_LEN_BITS'd1;
 
-                        if (WREADY_M1) ls_state_n = BRESP;
+                            if (WLAST_M1) ls_state_n = BRESP;
+                        end
                     end
                 end
             end
@@ -360,21 +500,27 @@ module CPU_wrapper (
                     ls_state_n = WDATA_TRANS;
                     
                     WVALID_M1 = 1'b1;
-                    WLAST_M1  = 1'b1;
-                    WSTRB_M1  = ls_request_q.strb;
-                    WDATA_M1  = ls_request_q.data;
+                    WLAST_M1  = (ls_count_q == ls_len_q);
 
-                    if (WREADY_M1) ls_state_n = BRESP;
+                    if (WREADY_M1) begin
+                        dcache_in_ready = 1'b1;
+                        ls_count_n      = ls_count_q + `AXI_LEN_BITS'd1;
+
+                        if (WLAST_M1) ls_state_n = BRESP;
+                    end
                 end
             end
 
             WDATA_TRANS : begin
                 WVALID_M1 = 1'b1;
-                WLAST_M1  = 1'b1;
-                WSTRB_M1  = ls_request_q.strb;
-                WDATA_M1  = ls_request_q.data;
+                WLAST_M1  = (ls_count_q == ls_len_q);
 
-                if (WREADY_M1) ls_state_n = BRESP;
+                if (WREADY_M1) begin
+                    dcache_in_ready = 1'b1;
+                    ls_count_n      = ls_count_q + `AXI_LEN_BITS'd1;
+
+                    if (WLAST_M1) ls_state_n = BRESP;
+                end
             end
 
             BRESP : begin
@@ -391,6 +537,107 @@ module CPU_wrapper (
         endcase
     end
 
+    // --------------------------------------------
+    //   Master3: Vector Non-Temporal Load / Store 
+    // --------------------------------------------
+    // whole vector unit-stride access in one burst,
+    // the data goes to the VPU directly and skips D$
+    always_ff @(posedge clk_i) begin
+        if (rst_i) begin
+            nt_state_q   <= IDLE;
+            nt_request_q <= BURST_REQUEST_t'(0);
+        end else begin
+            nt_state_q   <= nt_state_n;
+            nt_request_q <= nt_request_n;
+        end
+    end
+
+    always_comb begin
+        nt_state_n   = nt_state_q;
+        nt_request_n = nt_request_q;
+
+        // default AXI master output assignment
+        ARVALID_M3 = 1'b0;
+        ARID_M3    = 4'd0;
+        ARLEN_M3   = nt_request_q.len;
+        ARSIZE_M3  = `AXI_SIZE_WORD;
+        ARBURST_M3 = `AXI_BURST_INC;
+        ARADDR_M3  = nt_request_q.addr;
+        RREADY_M3  = 1'b0;
+        AWVALID_M3 = 1'b0;
+        AWID_M3    = 4'd0;
+        AWLEN_M3   = nt_request_q.len;
+        AWSIZE_M3  = `AXI_SIZE_WORD;
+        AWBURST_M3 = `AXI_BURST_INC;
+        AWADDR_M3  = nt_request_q.addr;
+        WVALID_M3  = 1'b0;
+        WDATA_M3   = vpu_nt_in;
+        WSTRB_M3   = vpu_nt_strb;
+        WLAST_M3   = 1'b0;
+        BREADY_M3  = 1'b0;
+
+        // default vpu response assignment
+        vpu_nt_wait      = nt_request_q.valid | vpu_nt_request;
+        vpu_nt_in_ready  = 1'b0;
+        vpu_nt_out_valid = 1'b0;
+        vpu_nt_out       = RDATA_M3;
+
+        unique case (nt_state_q)
+            IDLE : begin
+                if (vpu_nt_request) begin
+                    nt_request_n = {1'b1, vpu_nt_addr, vpu_nt_len, 4'd0};
+                    nt_state_n   = (vpu_nt_write) ? (AW_TRANS) : (AR_TRANS);
+                end
+            end
+
+            AR_TRANS : begin
+                ARVALID_M3 = 1'b1;
+
+                if (ARREADY_M3) nt_state_n = RDATA_TRANS;
+            end
+
+            RDATA_TRANS : begin
+                RREADY_M3        = 1'b1;
+                vpu_nt_out_valid = RVALID_M3;
+
+                if (RVALID_M3 & RLAST_M3) begin
+                    nt_state_n         = IDLE;
+                    nt_request_n.valid = 1'b0;
+                end
+            end
+
+            AW_TRANS : begin
+                AWVALID_M3 = 1'b1;
+
+                if (AWREADY_M3) nt_state_n = WDATA_TRANS;
+            end
+
+            WDATA_TRANS : begin
+                WVALID_M3       = 1'b1;
+                WLAST_M3        = (nt_request_q.count == nt_request_q.len);
+                vpu_nt_in_ready = WREADY_M3;
+
+                if (WREADY_M3) begin
+                    nt_request_n.count = nt_request_q.count + 4'd1;
+
+                    if (WLAST_M3) nt_state_n = BRESP;
+                end
+            end
+
+            BRESP : begin
+                BREADY_M3 = 1'b1;
+
+                if (BVALID_M3) begin
+                    nt_state_n         = IDLE;
+                    nt_request_n.valid = 1'b0;
+                    vpu_nt_wait        = 1'b0;
+                end
+            end
+
+            default : nt_state_n = IDLE;
+        endcase
+    end
+
     // --------------------------------------------
     //            Master 0/1 <---> I$,D$           
     // --------------------------------------------
@@ -408,12 +655,17 @@ module CPU_wrapper (
         .icache_core_wait_i    ( icache_core_wait    ),
         .icache_core_addr_i    ( icache_core_addr    ),
         .icache_core_out_i     ( icache_core_out     ),
+        .icache_pf_req_o       ( icache_pf_request   ),
+        .icache_pf_addr_o      ( icache_pf_addr      ),
+        .icache_inv_o          ( icache_inv          ),
 
         // exe stage request to D$
         .dcache_core_request_o ( dcache_core_request ),
         .dcache_core_write_o   ( dcache_core_write   ),
         .dcache_core_addr_o    ( dcache_core_addr    ),
         .dcache_core_in_o      ( dcache_core_in      ),
+        .dcache_core_pc_o      ( dcache_core_pc      ),
+        .dcache_core_cmo_o     ( dcache_core_cmo     ),
         .dcache_core_wait_i    ( dcache_core_wait    ),
         .dcache_core_out_i     ( dcache_core_out     ),
 
@@ -425,6 +677,7 @@ module CPU_wrapper (
         .vector_ack_i          ( vector_ack          ),
         .vector_writeback_i    ( vector_writeback    ),
         .vector_pend_lsu_i     ( vector_pend_lsu     ),
+        .vector_trap_o         ( vector_trap         ),
 
         // from VPU
         .vector_lsu_valid_i    ( vector_lsu_valid    ),
@@ -444,6 +697,7 @@ module CPU_wrapper (
         .vector_ack_o          ( vector_ack          ),
         .vector_writeback_o    ( vector_writeback    ),
         .vector_pend_lsu_o     ( vector_pend_lsu     ),
+        .vector_trap_i         ( vector_trap         ),
 
         // to CPU
         .vector_lsu_valid_o    ( vector_lsu_valid    ),
@@ -455,10 +709,36 @@ module CPU_wrapper (
         .dcache_vpu_write_o    ( dcache_vpu_write    ),
         .dcache_vpu_addr_o     ( dcache_vpu_addr     ),
         .dcache_vpu_in_o       ( dcache_vpu_in       ),
+        .dcache_vpu_inv_o      ( dcache_vpu_inv      ),
+
+        // prefetch hint to D$
+        .dcache_pf_request_o   ( dcache_pf_request   ),
+        .dcache_pf_addr_o      ( dcache_pf_addr      ),
+        .dcache_pf_end_o       ( dcache_pf_end       ),
 
         // response from D$
         .dcache_vpu_wait_i     ( dcache_vpu_wait     ),
-        .dcache_vpu_out_i      ( dcache_vpu_out      )
+        .dcache_vpu_out_i      ( dcache_vpu_out      ),
+        .dcache_sb_empty_i     ( dcache_sb_empty     ),
+
+        // non-temporal burst to master3
+        .nt_request_o          ( vpu_nt_request      ),
+        .nt_write_o            ( vpu_nt_write        ),
+        .nt_addr_o             ( vpu_nt_addr         ),
+        .nt_len_o              ( vpu_nt_len          ),
+        .nt_in_o               ( vpu_nt_in           ),
+        .nt_strb_o             ( vpu_nt_strb         ),
+        .nt_in_ready_i         ( vpu_nt_in_ready     ),
+        .nt_wait_i             ( vpu_nt_wait         ),
+        .nt_out_valid_i        ( vpu_nt_out_valid    ),
+        .nt_out_i              ( vpu_nt_out          ),
+
+        // vector scratchpad
+        .spm_request_o         ( vspm_request_o      ),
+        .spm_write_o           ( vspm_write_o        ),
+        .spm_addr_o            ( vspm_addr_o         ),
+        .spm_in_o              ( vspm_in_o           ),
+        .spm_out_i             ( vspm_out_i          )
     );
 
     L1C_inst L1CI (
@@ -471,13 +751,18 @@ module CPU_wrapper (
         .core_wait_o           ( icache_core_wait    ),
         .core_addr_o           ( icache_core_addr    ),
         .core_out_o            ( icache_core_out     ),
-
-        // D$ <-> master0
-        .D_req_o               ( icache_request      ),
-        .D_addr_o              ( icache_addr         ),
-        .D_wait_i              ( icache_wait         ),
-        .D_out_valid_i         ( icache_out_valid    ),
-        .D_out_i               ( icache_out          )
+        .pf_req_i              ( icache_pf_request   ),
+        .pf_addr_i             ( icache_pf_addr      ),
+        .inv_req_i             ( icache_inv          ),
+        .inv_hold_i            ( dcache_cmo_busy     ),
+
+        // D$ <-> L2 / master0
+        .D_req_o               ( l1i_request         ),
+        .D_len_o               ( l1i_len             ),
+        .D_addr_o              ( l1i_addr            ),
+        .D_wait_i              ( l1i_wait            ),
+        .D_out_valid_i         ( l1i_out_valid       ),
+        .D_out_i               ( l1i_out             )
     );
 
     L1C_data L1CD (
@@ -488,26 +773,122 @@ module CPU_wrapper (
         .core_req_i            ( dcache_core_request ),
         .core_write_i          ( dcache_core_write   ),
         .core_addr_i           ( dcache_core_addr    ),
+        .core_pc_i             ( dcache_core_pc      ),
         .core_in_i             ( dcache_core_in      ),
+        .core_cmo_i            ( dcache_core_cmo     ),
         .core_wait_o           ( dcache_core_wait    ),
         .core_out_o            ( dcache_core_out     ),
+        .cmo_busy_o            ( dcache_cmo_busy     ),
 
         // VPU <-> D$
         .vpu_request_i         ( dcache_vpu_request  ),
         .vpu_write_i           ( dcache_vpu_write    ),
         .vpu_addr_i            ( dcache_vpu_addr     ),
         .vpu_in_i              ( dcache_vpu_in       ),
+        .vpu_inv_i             ( dcache_vpu_inv      ),
         .vpu_wait_o            ( dcache_vpu_wait     ),
         .vpu_out_o             ( dcache_vpu_out      ),
-
-        // D$ <-> master1
-        .D_req_o               ( dcache_request      ),
-        .D_write_o             ( dcache_write        ),
-        .D_addr_o              ( dcache_addr         ),
-        .D_in_o                ( dcache_in           ),
-        .D_wait_i              ( dcache_wait         ),
-        .D_out_valid_i         ( dcache_out_valid    ),
-        .D_out_i               ( dcache_out          )
+        .sb_empty_o            ( dcache_sb_empty     ),
+
+        // VPU prefetch hint
+        .pf_req_i              ( dcache_pf_request   ),
+        .pf_addr_i             ( dcache_pf_addr      ),
+        .pf_end_i              ( dcache_pf_end       ),
+
+        // D$ -> L2 invalidate
+        .inv_req_o             ( l2_inv_request      ),
+        .inv_all_o             ( l2_inv_all          ),
+        .inv_addr_o            ( l2_inv_addr         ),
+        .inv_busy_i            ( l2_inv_busy         ),
+
+        // DMA snoop
+        .snoop_req_i,
+        .snoop_cmo_i,
+        .snoop_addr_i,
+        .snoop_len_i,
+        .snoop_wait_o,
+
+        // D$ <-> L2 / master1
+        .D_req_o               ( l1d_request         ),
+        .D_write_o             ( l1d_write           ),
+        .D_len_o               ( l1d_len             ),
+        .D_addr_o              ( l1d_addr            ),
+        .D_in_o                ( l1d_in              ),
+        .D_in_ready_i          ( l1d_in_ready        ),
+        .D_wait_i              ( l1d_wait            ),
+        .D_out_valid_i         ( l1d_out_valid       ),
+        .D_out_i               ( l1d_out             )
     );
 
+    generate
+        if (L2_ENABLE) begin : WITH_L2
+            L2C L2 (
+                .clk_i,
+                .rst_i,
+
+                // I$ <-> L2
+                .icache_req_i          ( l1i_request         ),
+                .icache_len_i          ( l1i_len             ),
+                .icache_addr_i         ( l1i_addr            ),
+                .icache_wait_o         ( l1i_wait            ),
+                .icache_out_valid_o    ( l1i_out_valid       ),
+                .icache_out_o          ( l1i_out             ),
+
+                // D$ <-> L2
+                .dcache_req_i          ( l1d_request         ),
+                .dcache_write_i        ( l1d_write           ),
+                .dcache_len_i          ( l1d_len             ),
+                .dcache_addr_i         ( l1d_addr            ),
+                .dcache_in_i           ( l1d_in              ),
+                .dcache_in_ready_o     ( l1d_in_ready        ),
+                .dcache_wait_o         ( l1d_wait            ),
+                .dcache_out_valid_o    ( l1d_out_valid       ),
+                .dcache_out_o          ( l1d_out             ),
+
+                // lines dropped by D$ (VPU non-temporal path, cbo.*, cache invalidate CSR)
+                .inv_req_i             ( l2_inv_request      ),
+                .inv_addr_i            ( l2_inv_addr         ),
+                .inv_busy_o            ( l2_inv_busy         ),
+                .inv_all_i             ( l2_inv_all          ),
+
+                // L2 <-> master0
+                .I_req_o               ( icache_request      ),
+                .I_len_o               ( icache_len          ),
+                .I_addr_o              ( icache_addr         ),
+                .I_wait_i              ( icache_wait         ),
+                .I_out_valid_i         ( icache_out_valid    ),
+                .I_out_i               ( icache_out          ),
+
+                // L2 <-> master1
+                .D_req_o               ( dcache_request      ),
+                .D_write_o             ( dcache_write        ),
+                .D_len_o               ( dcache_len          ),
+                .D_addr_o              ( dcache_addr         ),
+                .D_in_o                ( dcache_in           ),
+                .D_in_ready_i          ( dcache_in_ready     ),
+                .D_wait_i              ( dcache_wait         ),
+                .D_out_valid_i         ( dcache_out_valid    ),
+                .D_out_i               ( dcache_out          )
+            );
+        end else begin : NO_L2
+            assign icache_request   = l1i_request;
+            assign icache_len       = l1i_len;
+            assign icache_addr      = l1i_addr;
+            assign l1i_wait         = icache_wait;
+            assign l1i_out_valid    = icache_out_valid;
+            assign l1i_out          = icache_out;
+
+            assign dcache_request   = l1d_request;
+            assign dcache_write     = l1d_write;
+            assign dcache_len       = l1d_len;
+            assign dcache_addr      = l1d_addr;
+            assign dcache_in        = l1d_in;
+            assign l1d_in_ready     = dcache_in_ready;
+            assign l1d_wait         = dcache_wait;
+            assign l1d_out_valid    = dcache_out_valid;
+            assign l1d_out          = dcache_out;
+            assign l2_inv_busy      = 1'b0;
+        end
+    endgenerate
+
 endmodule
\ No newline at end of file
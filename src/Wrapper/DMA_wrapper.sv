@@ -6,6 +6,13 @@ module DMA_wrapper (
     // DMA interrupt port
     output logic                      DMA_interrupt_o,
 
+    // D$ snoop, the cached lines of a burst are cleaned / dropped around it
+    output logic                      snoop_req_o,
+    output CMO_t                      snoop_cmo_o,
+    output logic [`AXI_ADDR_BITS-1:0] snoop_addr_o,
+    output logic [`AXI_LEN_BITS -1:0] snoop_len_o,
+    input  logic                      snoop_wait_i,
+
     // AXI MASTER INTERFACE
     // AR channel
     output logic [`AXI_ID_BITS  -1:0] ARID_M,
@@ -84,7 +91,7 @@ module DMA_wrapper (
     // --------------------------------------------
     // master reading FSM
     typedef enum logic [1:0] {
-        MR_IDLE, MR_ADDR_TRANS, MR_DATA_TRANS
+        MR_IDLE, MR_SNOOP, MR_ADDR_TRANS, MR_DATA_TRANS
     } READ_STATE_t;
 
     READ_STATE_t               READ_STATE_q, READ_STATE_n;
@@ -94,6 +101,7 @@ module DMA_wrapper (
     logic                      read_finish;  // --> DMA
     logic                      read_valid;   // --> DMA
     logic [`AXI_DATA_BITS-1:0] read_data;    // --> DMA
+    logic                      read_snoop_done;  // <-- snoop
 
     always_ff @(posedge clk) begin
         if (rst) READ_STATE_q <= MR_IDLE;
@@ -121,20 +129,16 @@ module DMA_wrapper (
             MR_IDLE : begin
                 // receive DMA request when read_request is asserted
                 // otherwise, keep the previous read request
+                // the dirty lines in D$ are written back first
                 if (read_request) begin
-                    READ_STATE_n = MR_ADDR_TRANS;
-
-                    // actually we can send request to AXI bridge right now
-                    // assert AR valid, and set up read address
-                    ARVALID_M = 1'b1;
-                    ARADDR_M  = read_address;
-                    ARLEN_M   = read_length;
-
-                    // if AR handshake, go to next to receive data
-                    if (ARREADY_M) READ_STATE_n = MR_DATA_TRANS;
+                    READ_STATE_n = MR_SNOOP;
                 end
             end
 
+            MR_SNOOP : begin
+                if (read_snoop_done) READ_STATE_n = MR_ADDR_TRANS;
+            end
+
             MR_ADDR_TRANS: begin
                 ARVALID_M = 1'b1;
                 ARADDR_M  = read_address;
@@ -169,7 +173,7 @@ module DMA_wrapper (
     // --------------------------------------------
     // master writing FSM
     typedef enum logic [2:0] {
-        MW_IDLE, MW_ADDR_TRANS, MW_DATA_TRANS, MW_RESSPONSE
+        MW_IDLE, MW_SNOOP, MW_ADDR_TRANS, MW_DATA_TRANS, MW_RESSPONSE, MW_INVALIDATE
     } WRITE_STATE_t;
 
     WRITE_STATE_t              WRITE_STATE_q, WRITE_STATE_n;
@@ -180,6 +184,7 @@ module DMA_wrapper (
     logic                      write_last;    // <-- DMA
     logic                      write_valid;   // --> DMA
     logic                      write_finish;  // --> DMA
+    logic                      write_snoop_done; // <-- snoop
 
     always_ff @(posedge clk) begin
         if (rst) WRITE_STATE_q <= MW_IDLE;
@@ -210,32 +215,20 @@ module DMA_wrapper (
             MW_IDLE : begin
                 // receive DMA store request when store_request is asserted
                 // otherwise, keep the previous store request
+                // the lines in D$ are written back and dropped first
                 if (write_request) begin
-                    WRITE_STATE_n = MW_ADDR_TRANS;
-
-                    // actually we can send request to AXI bridge right now
-                    // if AW handshake, go to next to send data
-                    // to speed up, the W channel can send right away when AW channel handshake
-                    AWVALID_M = 1'b1;
-                    AWADDR_M  = write_address;
-                    AWLEN_M   = write_length;
-
-                    if (AWREADY_M) begin
-                        WRITE_STATE_n = MW_DATA_TRANS;
-
-                        WVALID_M = 1'b1;
-                        WDATA_M  = write_wData;
-                        WLAST_M  = write_last;
-                        
-                        if (WREADY_M) write_valid = 1'b1;
-                        if (WREADY_M && write_last) WRITE_STATE_n = MW_RESSPONSE;
-                    end
+                    WRITE_STATE_n = MW_SNOOP;
                 end
             end
 
+            MW_SNOOP : begin
+                if (write_snoop_done) WRITE_STATE_n = MW_ADDR_TRANS;
+            end
+
             MW_ADDR_TRANS : begin
                 AWVALID_M = 1'b1;
                 AWADDR_M  = write_address;
+                AWLEN_M   = write_length;
 
                 // if AW handshake, go to next to send data
                 // to speed up, the W channel can send right away when AW channel handshake
@@ -264,6 +257,13 @@ module DMA_wrapper (
                 BREADY_M = 1'b1;
 
                 if (BVALID_M) begin
+                    WRITE_STATE_n = MW_INVALIDATE;
+                end
+            end
+
+            // drop the lines filled while the burst was on the bus
+            MW_INVALIDATE : begin
+                if (write_snoop_done) begin
                     WRITE_STATE_n = MW_IDLE;
                     write_finish  = 1'b1;
                 end
@@ -273,6 +273,67 @@ module DMA_wrapper (
         endcase
     end
 
+    // --------------------------------------------
+    //                  Cache Snoop                
+    // --------------------------------------------
+    // ---------------------------------------------------------------
+    // The DMA reads / writes memory behind the caches, so a burst
+    // only goes out once D$ has handled the lines it covers: before
+    // a read the dirty lines are written back, before a write they
+    // are written back and dropped. After the B response the lines
+    // are dropped again (a line filled while the burst was on the
+    // bus is stale), then the DMA sees the write finish. One snoop
+    // at a time, the write master first.
+    // ---------------------------------------------------------------
+    typedef enum logic [1:0] {
+        SNOOP_IDLE, SNOOP_READ, SNOOP_WRITE
+    } SNOOP_STATE_t;
+
+    SNOOP_STATE_t              SNOOP_STATE_q, SNOOP_STATE_n;
+
+    always_ff @(posedge clk) begin
+        if (rst) SNOOP_STATE_q <= SNOOP_IDLE;
+        else     SNOOP_STATE_q <= SNOOP_STATE_n;
+    end
+
+    always_comb begin
+        SNOOP_STATE_n    = SNOOP_STATE_q;
+        read_snoop_done  = 1'b0;
+        write_snoop_done = 1'b0;
+
+        // default snoop assignment
+        snoop_req_o      = 1'b0;
+        snoop_cmo_o      = CMO_CLEAN;
+        snoop_addr_o     = read_address;
+        snoop_len_o      = read_length;
+
+        unique case (SNOOP_STATE_q)
+            SNOOP_IDLE : begin
+                if (WRITE_STATE_q == MW_SNOOP || WRITE_STATE_q == MW_INVALIDATE) begin
+                    SNOOP_STATE_n = SNOOP_WRITE;
+                    snoop_req_o   = 1'b1;
+                    snoop_cmo_o   = (WRITE_STATE_q == MW_SNOOP) ? (CMO_FLUSH) : (CMO_INVAL);
+                    snoop_addr_o  = write_address;
+                    snoop_len_o   = write_length;
+                end else if (READ_STATE_q == MR_SNOOP) begin
+                    SNOOP_STATE_n = SNOOP_READ;
+                    snoop_req_o   = 1'b1;
+                end
+            end
+
+            SNOOP_READ, SNOOP_WRITE : begin
+                // D$ is done (the written back lines are in memory)
+                if (!snoop_wait_i) begin
+                    SNOOP_STATE_n    = SNOOP_IDLE;
+                    read_snoop_done  = (SNOOP_STATE_q == SNOOP_READ);
+                    write_snoop_done = (SNOOP_STATE_q == SNOOP_WRITE);
+                end
+            end
+
+            default : SNOOP_STATE_n = SNOOP_IDLE;
+        endcase
+    end
+
     // --------------------------------------------
     //      Slave : Write DMA CSR (Write Only)     
     // --------------------------------------------
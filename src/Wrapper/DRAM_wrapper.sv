@@ -69,6 +69,7 @@ module DRAM_wrapper (
         logic [`AXI_ADDR_BITS-1:0] addr;  // Read/Write address
         logic [`AXI_LEN_BITS -1:0] len;   // Burst number
         logic [`AXI_SIZE_BITS-1:0] size;  // Burst size
+        logic [1:0]                burst; // Burst type (INCR / WRAP)
         logic [`AXI_DATA_BITS-1:0] data;  // Read/Write Data
         logic [`AXI_STRB_BITS-1:0] wstrb; // Write enable
         logic                      wlast; // Last write
@@ -144,6 +145,7 @@ module DRAM_wrapper (
                     REQUEST_n.addr  = ARADDR_S;
                     REQUEST_n.len   = ARLEN_S;
                     REQUEST_n.size  = ARSIZE_S;
+                    REQUEST_n.burst = ARBURST_S;
                     REQUEST_n.data  = 32'd0;
 
                     // we can now request the first read to DRAM
@@ -157,6 +159,7 @@ module DRAM_wrapper (
                     REQUEST_n.addr  = AWADDR_S;
                     REQUEST_n.len   = AWLEN_S;
                     REQUEST_n.size  = AWSIZE_S;
+                    REQUEST_n.burst = AWBURST_S;
                     REQUEST_n.data  = 32'd0;
                     REQUEST_n.wstrb = 4'd0;
                     REQUEST_n.wlast = 1'b0;
@@ -211,7 +214,7 @@ module DRAM_wrapper (
                     // we can send next read address to SRAM
                     if (!RLAST_S) begin
                         STATE_n        = READ;
-                        REQUEST_n.addr = REQUEST_q.addr + (32'd1 << REQUEST_q.size);
+                        REQUEST_n.addr = `AXI_NEXT_ADDR(REQUEST_q.addr, REQUEST_q.len, REQUEST_q.size, REQUEST_q.burst);
                         LOAD_REQ       = 1'b1;
                         ADDRESS        = REQUEST_n.addr;
                     end
@@ -240,7 +243,7 @@ module DRAM_wrapper (
                     // we can send next read address to SRAM
                     if (!RLAST_S) begin
                         STATE_n        = READ;
-                        REQUEST_n.addr = REQUEST_q.addr + (32'd1 << REQUEST_q.size);
+                        REQUEST_n.addr = `AXI_NEXT_ADDR(REQUEST_q.addr, REQUEST_q.len, REQUEST_q.size, REQUEST_q.burst);
                         LOAD_REQ       = 1'b1;
                         ADDRESS        = REQUEST_n.addr;
                     end
@@ -285,7 +288,7 @@ module DRAM_wrapper (
                     STATE_n   = WAIT_WVALID;
 
                     if (WVALID_S) begin
-                        REQUEST_n.addr  = REQUEST_q.addr + (32'd1 << REQUEST_q.size);
+                        REQUEST_n.addr  = `AXI_NEXT_ADDR(REQUEST_q.addr, REQUEST_q.len, REQUEST_q.size, REQUEST_q.burst);
                         REQUEST_n.data  = WDATA_S;
                         REQUEST_n.wstrb = WSTRB_S;
                         REQUEST_n.wlast = WLAST_S;
@@ -56,6 +56,7 @@ module IM_wrapper (
         logic [`AXI_ADDR_BITS-1:0] addr;
         logic [`AXI_LEN_BITS -1:0] len;
         logic [`AXI_SIZE_BITS-1:0] size;
+        logic [1:0]                burst;
     } REQUEST_t;
 
     STATE_t      STATE_q, STATE_n;
@@ -126,7 +127,7 @@ module IM_wrapper (
                 // wait for a read or write (AR/AW HandShake)
                 if (ARVALID_S) begin
                     STATE_n   = READ;
-                    REQUEST_n = {ARID_S, ARADDR_S, ARLEN_S, ARSIZE_S};
+                    REQUEST_n = {ARID_S, ARADDR_S, ARLEN_S, ARSIZE_S, ARBURST_S};
 
                     // We can now request the first read
                     // --> This can save time (SRAM needs two cycle to read)
@@ -136,7 +137,7 @@ module IM_wrapper (
 
                 end else if (AWVALID_S) begin
                     STATE_n   = WAIT_WVALID;
-                    REQUEST_n = {AWID_S, AWADDR_S, AWLEN_S, AWSIZE_S};
+                    REQUEST_n = {AWID_S, AWADDR_S, AWLEN_S, AWSIZE_S, AWBURST_S};
                     WREADY_S  = 1'b1;
 
                     // we can now request the first write
@@ -170,7 +171,7 @@ module IM_wrapper (
                     brust_counter_n = brust_counter_q + 4'd1;
                     
                     // calculate next read address
-                    REQUEST_n.addr  = REQUEST_q.addr + (32'd1 << REQUEST_q.size);
+                    REQUEST_n.addr  = `AXI_NEXT_ADDR(REQUEST_q.addr, REQUEST_q.len, REQUEST_q.size, REQUEST_q.burst);
                     ADDRESS         = REQUEST_n.addr;
                 end
             end
@@ -193,7 +194,7 @@ module IM_wrapper (
                 // wait W channel handshake
                 if (WVALID_S) begin
                     WRITE_REQ       = 1'b1;
-                    REQUEST_n.addr  = REQUEST_q.addr + (32'd1 << REQUEST_q.size);
+                    REQUEST_n.addr  = `AXI_NEXT_ADDR(REQUEST_q.addr, REQUEST_q.len, REQUEST_q.size, REQUEST_q.burst);
                     ADDRESS         = REQUEST_n.addr;
                     brust_counter_n = brust_counter_q + 4'd1;
                     STATE_n         = (WLAST_S) ? (RESPONSE) : (WRITE);
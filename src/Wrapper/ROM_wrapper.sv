@@ -58,6 +58,7 @@ module ROM_wrapper (
         logic [`AXI_ADDR_BITS-1:0] addr;
         logic [`AXI_LEN_BITS -1:0] len;
         logic [`AXI_SIZE_BITS-1:0] size;
+        logic [1:0]                burst;
     } REQUEST_t;
 
     STATE_t      STATE_q, STATE_n;
@@ -100,7 +101,7 @@ module ROM_wrapper (
                 // wait for ROM_address read (AR HandShake)
                 if (ARVALID_S) begin
                     STATE_n   = READ;
-                    REQUEST_n = {ARID_S, ARADDR_S, ARLEN_S, ARSIZE_S};
+                    REQUEST_n = {ARID_S, ARADDR_S, ARLEN_S, ARSIZE_S, ARBURST_S};
 
                     // we can now request the first read
                     // --> this can save time (ROM needs two cycle to read)
@@ -130,7 +131,7 @@ module ROM_wrapper (
                     brust_counter_n = brust_counter_q + 4'd1;
                     
                     // calculate next read address
-                    REQUEST_n.addr  = REQUEST_q.addr + (32'd1 << REQUEST_q.size);
+                    REQUEST_n.addr  = `AXI_NEXT_ADDR(REQUEST_q.addr, REQUEST_q.len, REQUEST_q.size, REQUEST_q.burst);
                     ROM_address     = REQUEST_n.addr[13:2];
                 end
             end
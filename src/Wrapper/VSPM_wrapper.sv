@@ -0,0 +1,316 @@
+`include "../include/AXI_define.svh"
+
+// --------------------------------------------
+// Vector scratchpad memory
+// * two 32-bit SRAM banks side by side, so one row is one 64-bit vreg slice
+// * VPU port : one 64-bit access per cycle, always has priority
+// * AXI port : 32-bit slave (DMA / CPU), waits when the VPU uses the SRAM
+// --------------------------------------------
+module VSPM_wrapper (
+    input  logic                      clk,
+    input  logic                      rst,
+    input  logic [31:0]               BASE_ADDR,
+
+    // --------------------------------------------
+    //              VPU Direct Interface           
+    // --------------------------------------------
+    input  logic                      vpu_request_i,
+    input  logic [ 7:0]               vpu_write_i,  // byte write enable, 0 for read
+    input  logic [31:0]               vpu_addr_i,
+    input  logic [63:0]               vpu_in_i,
+    output logic [63:0]               vpu_out_o,    // valid in the next cycle
+
+    // --------------------------------------------
+    //              AXI Slave Interface            
+    // --------------------------------------------
+    // AR channel
+    input  logic [`AXI_IDS_BITS -1:0] ARID_S,
+    input  logic [`AXI_DATA_BITS-1:0] ARADDR_S,
+    input  logic [`AXI_LEN_BITS -1:0] ARLEN_S,
+    input  logic [`AXI_SIZE_BITS-1:0] ARSIZE_S,
+    input  logic [1:0]                ARBURST_S,
+    input  logic                      ARVALID_S,
+    output logic                      ARREADY_S,
+    // R channel
+    output logic [`AXI_IDS_BITS -1:0] RID_S,
+    output logic [`AXI_DATA_BITS-1:0] RDATA_S,
+    output logic [1:0]                RRESP_S,
+    output logic                      RLAST_S,
+    output logic                      RVALID_S,
+    input  logic                      RREADY_S,
+    // AW channel
+    input  logic [`AXI_IDS_BITS -1:0] AWID_S,
+    input  logic [`AXI_ADDR_BITS-1:0] AWADDR_S,
+    input  logic [`AXI_LEN_BITS -1:0] AWLEN_S,
+    input  logic [`AXI_SIZE_BITS-1:0] AWSIZE_S,
+    input  logic [1:0]                AWBURST_S,
+    input  logic                      AWVALID_S,
+    output logic                      AWREADY_S,
+    // W channel
+    input  logic [`AXI_DATA_BITS-1:0] WDATA_S,
+    input  logic [`AXI_STRB_BITS-1:0] WSTRB_S,
+    input  logic                      WLAST_S,
+    input  logic                      WVALID_S,
+    output logic                      WREADY_S,
+    // B channel
+    output logic [`AXI_IDS_BITS -1:0] BID_S,
+    output logic [1:0]                BRESP_S,
+    output logic                      BVALID_S,
+    input  logic                      BREADY_S
+);
+
+    // --------------------------------------------
+    //              Signal Declaration             
+    // --------------------------------------------
+    // slave FSM
+    typedef enum logic [2:0] {
+        INIT, IDLE, READ, WRITE, WAIT_WVALID, RESPONSE
+    } STATE_t;
+
+    // request structute
+    typedef struct packed {
+        logic [`AXI_IDS_BITS -1:0] id;
+        logic [`AXI_ADDR_BITS-1:0] addr;
+        logic [`AXI_LEN_BITS -1:0] len;
+        logic [`AXI_SIZE_BITS-1:0] size;
+        logic [1:0]                burst;
+    } REQUEST_t;
+
+    STATE_t      STATE_q, STATE_n;
+    REQUEST_t    REQUEST_q, REQUEST_n;
+    logic [ 3:0] brust_counter_q, brust_counter_n;
+    logic        WRITE_REQ, LOAD_REQ;
+    logic [31:0] DI, DO, ADDRESS, real_addr, vpu_real_addr;
+
+    // AXI access is granted only when the VPU does not use the SRAM
+    logic        axi_grant;
+    logic        axi_load_q; // SRAM output belongs to AXI
+    logic        axi_bank_q; // which bank AXI read in the last cycle
+
+    // R beat holding register, keeps RVALID/RDATA stable until RREADY
+    logic        rbuf_valid_q, rbuf_valid_n;
+    logic [31:0] rbuf_data_q,  rbuf_data_n;
+
+    logic        SRAM_CEB [2];
+    logic        SRAM_WEB [2];
+    logic [13:0] SRAM_A   [2];
+    logic [31:0] SRAM_DI  [2];
+    logic [31:0] SRAM_BWEB[2];
+    logic [31:0] SRAM_DO  [2];
+
+    // --------------------------------------------
+    //                 SRAM Module                 
+    // --------------------------------------------
+    // bank0 holds addr[2] == 0 words, bank1 holds addr[2] == 1 words
+    assign real_addr     = ADDRESS    - BASE_ADDR;
+    assign vpu_real_addr = vpu_addr_i - BASE_ADDR;
+    assign axi_grant     = ~vpu_request_i;
+
+    always_comb begin
+        for (int i = 0; i < 2; i++) begin
+            if (vpu_request_i) begin
+                SRAM_CEB [i] = 1'b0;
+                SRAM_WEB [i] = ~(|vpu_write_i);
+                SRAM_A   [i] = vpu_real_addr[16:3];
+                SRAM_DI  [i] = vpu_in_i[i*32 +: 32];
+                SRAM_BWEB[i] = {{8{~vpu_write_i[i*4+3]}}, {8{~vpu_write_i[i*4+2]}},
+                                {8{~vpu_write_i[i*4+1]}}, {8{~vpu_write_i[i*4+0]}}};
+            end else begin
+                // both banks are read, only the addressed bank is written
+                SRAM_CEB [i] = ~(LOAD_REQ | (WRITE_REQ & (real_addr[2] == 1'(i))));
+                SRAM_WEB [i] = ~WRITE_REQ;
+                SRAM_A   [i] = real_addr[16:3];
+                SRAM_DI  [i] = DI;
+                SRAM_BWEB[i] = {{8{~WSTRB_S[3]}}, {8{~WSTRB_S[2]}}, {8{~WSTRB_S[1]}}, {8{~WSTRB_S[0]}}};
+            end
+        end
+    end
+
+    assign vpu_out_o = {SRAM_DO[1], SRAM_DO[0]};
+    assign DO        = (axi_bank_q) ? (SRAM_DO[1]) : (SRAM_DO[0]);
+
+    TS1N16ADFPCLLLVTA512X45M4SWSHOD i_SRAM0 (
+        .SLP     ( 1'b0         ),
+        .DSLP    ( 1'b0         ),
+        .SD      ( 1'b0         ),
+        .PUDELAY (              ),
+        .CLK     ( clk          ),
+        .CEB     ( SRAM_CEB [0] ),
+        .WEB     ( SRAM_WEB [0] ),
+        .A       ( SRAM_A   [0] ),
+        .D       ( SRAM_DI  [0] ),
+        .BWEB    ( SRAM_BWEB[0] ),
+        .RTSEL   ( 2'b01        ),
+        .WTSEL   ( 2'b01        ),
+        .Q       ( SRAM_DO  [0] )
+    );
+
+    TS1N16ADFPCLLLVTA512X45M4SWSHOD i_SRAM1 (
+        .SLP     ( 1'b0         ),
+        .DSLP    ( 1'b0         ),
+        .SD      ( 1'b0         ),
+        .PUDELAY (              ),
+        .CLK     ( clk          ),
+        .CEB     ( SRAM_CEB [1] ),
+        .WEB     ( SRAM_WEB [1] ),
+        .A       ( SRAM_A   [1] ),
+        .D       ( SRAM_DI  [1] ),
+        .BWEB    ( SRAM_BWEB[1] ),
+        .RTSEL   ( 2'b01        ),
+        .WTSEL   ( 2'b01        ),
+        .Q       ( SRAM_DO  [1] )
+    );
+
+    // --------------------------------------------
+    //                  AXI Slave                  
+    // --------------------------------------------
+    always_comb begin
+        STATE_n         = STATE_q;
+        REQUEST_n       = REQUEST_q;
+        brust_counter_n = brust_counter_q;
+        rbuf_valid_n    = rbuf_valid_q;
+        rbuf_data_n     = rbuf_data_q;
+
+        // Memory default assignment
+        ADDRESS         = ARADDR_S;
+        DI              = WDATA_S;
+        LOAD_REQ        = 1'b0;
+        WRITE_REQ       = 1'b0;
+
+        // AXI default assignment
+        ARREADY_S       = 1'b0;
+        RID_S           = REQUEST_q.id;
+        RDATA_S         = DO;
+        RRESP_S         = `AXI_RESP_OKAY;
+        RLAST_S         = 1'b0;
+        RVALID_S        = 1'b0;
+        AWREADY_S       = 1'b0;
+        WREADY_S        = 1'b0;
+        BID_S           = REQUEST_q.id;
+        BRESP_S         = `AXI_RESP_OKAY;
+        BVALID_S        = 1'b0;
+
+        unique case (STATE_q)
+            IDLE: begin
+                // assert AR/SW ready to receive load/store request
+                ARREADY_S = 1'b1;
+                AWREADY_S = 1'b1;
+
+                // wait for a read or write (AR/AW HandShake)
+                if (ARVALID_S) begin
+                    STATE_n   = READ;
+                    REQUEST_n = {ARID_S, ARADDR_S, ARLEN_S, ARSIZE_S, ARBURST_S};
+
+                    // request the first read if the VPU is not using the SRAM
+                    LOAD_REQ        = axi_grant;
+                    ADDRESS         = ARADDR_S;
+                    brust_counter_n = 4'd1;
+
+                end else if (AWVALID_S) begin
+                    STATE_n   = WAIT_WVALID;
+                    REQUEST_n = {AWID_S, AWADDR_S, AWLEN_S, AWSIZE_S, AWBURST_S};
+                    WREADY_S  = axi_grant;
+
+                    // we can now request the first write
+                    if (WVALID_S && axi_grant) begin
+                        WRITE_REQ       = 1'b1;
+                        ADDRESS         = AWADDR_S;
+                        brust_counter_n = 4'd1;
+                        STATE_n         = (WLAST_S) ? (RESPONSE) : (WRITE);
+                    end
+                end
+            end
+
+            READ: begin
+                // R channel response (SRAM output is valid only if AXI read it in the last cycle)
+                // a presented beat is held in rbuf, a VPU access cannot withdraw it before RREADY
+                RVALID_S = axi_load_q | rbuf_valid_q;
+                RID_S    = REQUEST_q.id;
+                RDATA_S  = (rbuf_valid_q) ? (rbuf_data_q) : (DO);
+                RLAST_S  = (brust_counter_q == REQUEST_q.len + 4'd1);
+
+                // keep reading the same address until a beat is presented
+                LOAD_REQ = axi_grant & ~RVALID_S;
+                ADDRESS  = REQUEST_q.addr;
+
+                // R channel handshake (Data is successfully transfered)
+                // we can send next read address to SRAM
+                if (RVALID_S && RREADY_S) begin
+                    RRESP_S         = `AXI_RESP_OKAY;
+                    STATE_n         = (RLAST_S) ? IDLE : READ;
+                    brust_counter_n = brust_counter_q + 4'd1;
+                    rbuf_valid_n    = 1'b0;
+
+                    // calculate next read address
+                    REQUEST_n.addr  = `AXI_NEXT_ADDR(REQUEST_q.addr, REQUEST_q.len, REQUEST_q.size, REQUEST_q.burst);
+                    ADDRESS         = REQUEST_n.addr;
+                    LOAD_REQ        = axi_grant;
+
+                // master is not ready, hold the beat
+                end else if (RVALID_S) begin
+                    rbuf_valid_n    = 1'b1;
+                    rbuf_data_n     = RDATA_S;
+                end
+            end
+
+            WAIT_WVALID : begin
+                WREADY_S = axi_grant;
+
+                // we can now request the first write
+                if (WVALID_S && axi_grant) begin
+                    WRITE_REQ       = 1'b1;
+                    ADDRESS         = REQUEST_q.addr;
+                    brust_counter_n = 4'd1;
+                    STATE_n         = (WLAST_S) ? (RESPONSE) : (WRITE);
+                end
+            end
+
+            WRITE : begin
+                WREADY_S = axi_grant;
+
+                // wait W channel handshake
+                if (WVALID_S && axi_grant) begin
+                    WRITE_REQ       = 1'b1;
+                    REQUEST_n.addr  = `AXI_NEXT_ADDR(REQUEST_q.addr, REQUEST_q.len, REQUEST_q.size, REQUEST_q.burst);
+                    ADDRESS         = REQUEST_n.addr;
+                    brust_counter_n = brust_counter_q + 4'd1;
+                    STATE_n         = (WLAST_S) ? (RESPONSE) : (WRITE);
+                end
+            end
+
+            RESPONSE : begin
+                BVALID_S = 1'b1;
+                BID_S    = REQUEST_q.id;
+
+                // wait B channel handshake
+                if (BREADY_S) begin
+                    STATE_n = IDLE;
+                    BRESP_S = `AXI_RESP_OKAY;
+                end
+            end
+
+            default: STATE_n = IDLE;
+        endcase
+    end
+
+    always_ff @(posedge clk) begin
+        if (rst) begin
+            STATE_q         <= INIT;
+            brust_counter_q <= 4'd0;
+            REQUEST_q       <= REQUEST_t'(0);
+            axi_load_q      <= 1'b0;
+            axi_bank_q      <= 1'b0;
+            rbuf_valid_q    <= 1'b0;
+            rbuf_data_q     <= 32'd0;
+        end else begin
+            STATE_q         <= STATE_n;
+            brust_counter_q <= brust_counter_n;
+            REQUEST_q       <= REQUEST_n;
+            axi_load_q      <= LOAD_REQ;
+            axi_bank_q      <= real_addr[2];
+            rbuf_valid_q    <= rbuf_valid_n;
+            rbuf_data_q     <= rbuf_data_n;
+        end
+    end
+
+endmodule
@@ -5,8 +5,10 @@
 ../src/AXI/AXI.sv
 ../src/Cache/data_array_wrapper.sv
 ../src/Cache/tag_array_wrapper.sv
+../src/Cache/cache_plru.sv
 ../src/Cache/L1C_data.sv
 ../src/Cache/L1C_inst.sv
+../src/Cache/L2C.sv
 ../src/CPU/CPU.sv
 ../src/CPU/if_stage.sv
 ../src/CPU/id_stage.sv
@@ -43,10 +45,12 @@
 ../src/VPU/VPU_sld.sv
 ../src/VPU/VPU_elem.sv
 ../src/VPU/VPU_mask.sv
+../src/VPU/VPU_fixp.sv
 ../src/VPU/VPU_lsu.sv
 ../src/VPU/VPU_regfile.sv
 ../src/VPU/VPU_lane.sv
 ../src/VPU/VPU_lane_wrapper.sv
+../src/VPU/VPU_clock_gate.sv
 ../src/Wrapper/CPU_wrapper.sv
 ../src/Wrapper/DMA_wrapper.sv
 ../src/Wrapper/DRAM_wrapper.sv
@@ -54,4 +58,5 @@
 ../src/Wrapper/IM_wrapper.sv
 ../src/Wrapper/DM_wrapper.sv
 ../src/Wrapper/WDT_wrapper.sv
+../src/Wrapper/VSPM_wrapper.sv
 /usr/cad/CBDK/Executable_Package/Collaterals/IP/stdio/N16ADFP_StdIO/VERILOG/N16ADFP_StdIO.v
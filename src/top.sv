@@ -122,6 +122,20 @@ module top (
     logic                      DMA_interrupt;
     logic                      WDT_interrupt;
 
+    // DMA -> D$ snoop
+    logic                      dma_snoop_req;
+    CMO_t                      dma_snoop_cmo;
+    logic [31:0]               dma_snoop_addr;
+    logic [ 3:0]               dma_snoop_len;
+    logic                      dma_snoop_wait;
+
+    // VPU <-> vector scratchpad
+    logic                      vspm_request;
+    logic [ 7:0]               vspm_write;
+    logic [31:0]               vspm_addr;
+    logic [63:0]               vspm_in;
+    logic [63:0]               vspm_out;
+
     // --------------------------------------------
     //                    System                   
     // --------------------------------------------
@@ -132,6 +146,12 @@ module top (
         .DMA_interrupt_i  ( DMA_interrupt    ),
         .WDT_interrupt_i  ( WDT_interrupt    ),
 
+        .snoop_req_i      ( dma_snoop_req    ),
+        .snoop_cmo_i      ( dma_snoop_cmo    ),
+        .snoop_addr_i     ( dma_snoop_addr   ),
+        .snoop_len_i      ( dma_snoop_len    ),
+        .snoop_wait_o     ( dma_snoop_wait   ),
+
         .ARID_M0          ( ARID_M   [0]     ),
         .ARADDR_M0        ( ARADDR_M [0]     ),
         .ARLEN_M0         ( ARLEN_M  [0]     ),
@@ -190,7 +210,43 @@ module top (
         .BID_M1           ( BID_M    [1]     ),
         .BRESP_M1         ( BRESP_M  [1]     ),
         .BVALID_M1        ( BVALID_M [1]     ),
-        .BREADY_M1        ( BREADY_M [1]     )
+        .BREADY_M1        ( BREADY_M [1]     ),
+
+        .ARID_M3          ( ARID_M   [3]     ),
+        .ARADDR_M3        ( ARADDR_M [3]     ),
+        .ARLEN_M3         ( ARLEN_M  [3]     ),
+        .ARSIZE_M3        ( ARSIZE_M [3]     ),
+        .ARBURST_M3       ( ARBURST_M[3]     ),
+        .ARVALID_M3       ( ARVALID_M[3]     ),
+        .ARREADY_M3       ( ARREADY_M[3]     ),
+        .RID_M3           ( RID_M    [3]     ),
+        .RDATA_M3         ( RDATA_M  [3]     ),
+        .RRESP_M3         ( RRESP_M  [3]     ),
+        .RLAST_M3         ( RLAST_M  [3]     ),
+        .RVALID_M3        ( RVALID_M [3]     ),
+        .RREADY_M3        ( RREADY_M [3]     ),
+        .AWID_M3          ( AWID_M   [3]     ),
+        .AWADDR_M3        ( AWADDR_M [3]     ),
+        .AWLEN_M3         ( AWLEN_M  [3]     ),
+        .AWSIZE_M3        ( AWSIZE_M [3]     ),
+        .AWBURST_M3       ( AWBURST_M[3]     ),
+        .AWVALID_M3       ( AWVALID_M[3]     ),
+        .AWREADY_M3       ( AWREADY_M[3]     ),
+        .WDATA_M3         ( WDATA_M  [3]     ),
+        .WSTRB_M3         ( WSTRB_M  [3]     ),
+        .WLAST_M3         ( WLAST_M  [3]     ),
+        .WVALID_M3        ( WVALID_M [3]     ),
+        .WREADY_M3        ( WREADY_M [3]     ),
+        .BID_M3           ( BID_M    [3]     ),
+        .BRESP_M3         ( BRESP_M  [3]     ),
+        .BVALID_M3        ( BVALID_M [3]     ),
+        .BREADY_M3        ( BREADY_M [3]     ),
+
+        .vspm_request_o   ( vspm_request     ),
+        .vspm_write_o     ( vspm_write       ),
+        .vspm_addr_o      ( vspm_addr        ),
+        .vspm_in_o        ( vspm_in          ),
+        .vspm_out_i       ( vspm_out         )
     );
 
     DMA_wrapper DMA_wrapper (
@@ -199,6 +255,12 @@ module top (
         .BASE_ADDR        ( `DMA_start_addr  ),
         .DMA_interrupt_o  ( DMA_interrupt    ),
 
+        .snoop_req_o      ( dma_snoop_req    ),
+        .snoop_cmo_o      ( dma_snoop_cmo    ),
+        .snoop_addr_o     ( dma_snoop_addr   ),
+        .snoop_len_o      ( dma_snoop_len    ),
+        .snoop_wait_i     ( dma_snoop_wait   ),
+
         .ARID_M           ( ARID_M   [2]     ),
         .ARADDR_M         ( ARADDR_M [2]     ),
         .ARLEN_M          ( ARLEN_M  [2]     ),
@@ -522,4 +584,46 @@ module top (
         .BREADY_S        ( BREADY_S [5]     )
     );
 
+    VSPM_wrapper VSPM_wrapper (
+        .clk             ( cpu_clk          ),
+        .rst             ( cpu_rst          ),
+        .BASE_ADDR       ( `VSPM_start_addr ),
+
+        .vpu_request_i   ( vspm_request     ),
+        .vpu_write_i     ( vspm_write       ),
+        .vpu_addr_i      ( vspm_addr        ),
+        .vpu_in_i        ( vspm_in          ),
+        .vpu_out_o       ( vspm_out         ),
+
+        .ARID_S          ( ARID_S   [6]     ),
+        .ARADDR_S        ( ARADDR_S [6]     ),
+        .ARLEN_S         ( ARLEN_S  [6]     ),
+        .ARSIZE_S        ( ARSIZE_S [6]     ),
+        .ARBURST_S       ( ARBURST_S[6]     ),
+        .ARVALID_S       ( ARVALID_S[6]     ),
+        .ARREADY_S       ( ARREADY_S[6]     ),
+        .RID_S           ( RID_S    [6]     ),
+        .RDATA_S         ( RDATA_S  [6]     ),
+        .RRESP_S         ( RRESP_S  [6]     ),
+        .RLAST_S         ( RLAST_S  [6]     ),
+        .RVALID_S        ( RVALID_S [6]     ),
+        .RREADY_S        ( RREADY_S [6]     ),
+        .AWID_S          ( AWID_S   [6]     ),
+        .AWADDR_S        ( AWADDR_S [6]     ),
+        .AWLEN_S         ( AWLEN_S  [6]     ),
+        .AWSIZE_S        ( AWSIZE_S [6]     ),
+        .AWBURST_S       ( AWBURST_S[6]     ),
+        .AWVALID_S       ( AWVALID_S[6]     ),
+        .AWREADY_S       ( AWREADY_S[6]     ),
+        .WDATA_S         ( WDATA_S  [6]     ),
+        .WSTRB_S         ( WSTRB_S  [6]     ),
+        .WLAST_S         ( WLAST_S  [6]     ),
+        .WVALID_S        ( WVALID_S [6]     ),
+        .WREADY_S        ( WREADY_S [6]     ),
+        .BID_S           ( BID_S    [6]     ),
+        .BRESP_S         ( BRESP_S  [6]     ),
+        .BVALID_S        ( BVALID_S [6]     ),
+        .BREADY_S        ( BREADY_S [6]     )
+    );
+
 endmodule
\ No newline at end of file